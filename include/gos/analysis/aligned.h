@@ -0,0 +1,54 @@
+#ifndef GOS_ANALYSIS_ALIGNED_H_
+#define GOS_ANALYSIS_ALIGNED_H_
+
+#include <cstddef>
+
+#include <new>
+
+namespace gos {
+namespace analysis {
+namespace aligned {
+
+/* Cache line alignment, wide enough for any SIMD register */
+const ::std::size_t Alignment = 64;
+
+/* Allocator for containers whose data must start on an aligned address */
+template<typename T, ::std::size_t A = Alignment> class allocator {
+public:
+  typedef T value_type;
+
+  template<typename U> struct rebind {
+    typedef allocator<U, A> other;
+  };
+
+  allocator() noexcept {
+  }
+
+  template<typename U> allocator(const allocator<U, A>&) noexcept {
+  }
+
+  T* allocate(::std::size_t count) {
+    return static_cast<T*>(
+      ::operator new(count * sizeof(T), ::std::align_val_t(A)));
+  }
+
+  void deallocate(T* pointer, ::std::size_t) noexcept {
+    ::operator delete(pointer, ::std::align_val_t(A));
+  }
+};
+
+template<typename T, typename U, ::std::size_t A>
+bool operator==(const allocator<T, A>&, const allocator<U, A>&) {
+  return true;
+}
+
+template<typename T, typename U, ::std::size_t A>
+bool operator!=(const allocator<T, A>&, const allocator<U, A>&) {
+  return false;
+}
+
+} // namespace aligned
+} // namespace analysis
+} // namespace gos
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef GOS_ANALYSIS_BATCH_H_
+#define GOS_ANALYSIS_BATCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <string>
+#include <vector>
+
+#include <gos/analysis/pool.h>
+
+namespace gos {
+namespace analysis {
+namespace batch {
+
+struct Options {
+  Options();
+  /* The temperature window and standard deviation threshold of the filter */
+  size_t WindowSize;
+  double Threshold;
+  /* The most bytes of files loaded at the same time, a file larger than
+     the limit is still loaded but on its own */
+  ::std::uint64_t Limit;
+};
+
+/* The summary of one run, the statistics are of the temperature */
+struct Summary {
+  Summary();
+  ::std::string File;
+  ::std::uint64_t Bytes;
+  size_t Rows;
+  /* Rows without a temperature */
+  size_t Missing;
+  /* Rows kept by the filter */
+  size_t Stable;
+  double Duration;
+  double Mean;
+  double Sd;
+  double Minimum;
+  double Maximum;
+  double StableMean;
+  /* Empty unless the run could not be analysed */
+  ::std::string Error;
+};
+
+typedef ::std::vector<Summary> SummaryVector;
+
+/* Parse the time and temperature columns of a standard or PID log, filter
+   the temperature and summarise it. A failure is reported in Error. */
+Summary summarize(const char* filepath, const Options& options);
+
+/* Summarise the files on the pool, the largest files are started first so
+   the small ones fill in around them. The summaries are in the order of
+   the files. */
+void summarize(
+  SummaryVector& summaries,
+  const ::std::vector<::std::string>& filepaths,
+  const Options& options,
+  ::gos::analysis::pool& pool = ::gos::analysis::pool::shared());
+
+/* Write the summaries as one CSV table */
+void write(const SummaryVector& summaries, const char* filepath);
+
+void write(const SummaryVector& summaries, ::std::FILE* file);
+
+} // namespace batch
+} // namespace analysis
+} // namespace gos
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef GOS_ANALYSIS_BINARY_H_
+#define GOS_ANALYSIS_BINARY_H_
+
+#include <cstdint>
+#include <cstdio>
+
+#include <string>
+#include <vector>
+
+#include <gos/analysis/tc.h>
+
+namespace gos {
+namespace analysis {
+namespace tc {
+namespace binary {
+
+/* The binary columnar cache format (.tcb), native byte order
+
+   | Offset | Type       | Description                                   |
+   |--------|------------|-----------------------------------------------|
+   |      0 | char[4]    | Magic "GTCB"                                  |
+   |      4 | uint32     | Version                                       |
+   |      8 | uint32     | Byte order mark, 1 in the writer's byte order |
+   |     12 | uint32     | Number of columns, time, control, temperature |
+   |     16 | uint64     | Number of rows                                |
+   |     24 | uint64     | Size of the source file                       |
+   |     32 | uint64     | Checksum of the column data                   |
+   |     40 | uint64[3]  | Offset of every column from the file start    |
+
+   The columns are arrays of double, each starting on a 64 byte boundary */
+
+const ::std::uint32_t Version = 1;
+
+/* The cache file path for a source file, .tcb appended to its name so
+   sources differing only in extension do not share a cache */
+::std::string path(const char* filepath);
+
+/* A path next to the file unique to the writing process, thread and call,
+   to write to and rename into place so a reader never sees a partial file */
+::std::string temporary(const char* filepath);
+
+void write(
+  const StandardFrame& frame,
+  const char* tcbpath,
+  const ::std::uint64_t& sourcesize = 0);
+
+/* Writes a cache file row by row without holding the columns in memory.
+   The time column goes to the file and the others are spilled to
+   temporary files in blocks, close appends them and writes the header.
+   The file is replaced only by close, a writer destroyed before that
+   removes what it wrote. */
+class writer {
+public:
+  writer(const char* tcbpath, const ::std::uint64_t& sourcesize = 0);
+
+  ~writer();
+
+  writer(const writer&) = delete;
+  writer& operator=(const writer&) = delete;
+
+  void add(
+    const double& time,
+    const double& control,
+    const double& temperature);
+
+  /* Throws if the file could not be written or replaced */
+  void close();
+
+  /* The number of rows added so far */
+  const ::std::uint64_t& count() const;
+
+private:
+  void flush();
+  void discard();
+
+  ::std::string tcbpath_;
+  ::std::uint64_t sourcesize_;
+  ::std::uint64_t count_;
+  ::std::string temporaries_[3];
+  ::std::FILE* files_[3];
+  ::std::vector<double> columns_[3];
+  ::std::uint64_t lanes_[3][4];
+};
+
+/* Append the rows of a cache file, false if the file cannot be opened, is
+   not a valid cache or the checksum does not match */
+bool read(StandardFrame& frame, const char* tcbpath);
+
+/* Append the rows from the cache of the source file, false if there is no
+   cache, it cannot be opened, it is older than the source or it is not
+   valid */
+bool load(StandardFrame& frame, const char* filepath);
+
+/* Write the cache of the source file, false if it could not be written */
+bool save(const StandardFrame& frame, const char* filepath);
+
+} // namespace binary
+} // namespace tc
+} // namespace analysis
+} // namespace gos
+
+#endif
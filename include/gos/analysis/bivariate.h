@@ -0,0 +1,63 @@
+#ifndef GOS_ANALYSIS_BIVARIATE_H_
+#define GOS_ANALYSIS_BIVARIATE_H_
+
+#include <gos/analysis/types.h>
+
+namespace gos {
+namespace analysis {
+
+/* Window over pairs of values with running moments and cross moment, so
+   the covariance and the correlation are constant time per pair */
+class bivariate {
+public:
+  bivariate();
+
+  bivariate(const size_t& size);
+
+  void add(const double& x, const double& y);
+
+  void set(const size_t& size);
+
+  const size_t& size() const;
+
+  size_t count() const;
+
+  void clear();
+
+  const double& meanx() const;
+
+  const double& meany() const;
+
+  double variancex() const;
+
+  double variancey() const;
+
+  double covariance() const;
+
+  /* The Pearson correlation coefficient, 0 when either variance is 0 */
+  double correlation() const;
+
+private:
+  void synchronize();
+
+  /* Circular buffers, the oldest pair is at head_ */
+  ::gos::analysis::type::DoubleVector x_;
+  ::gos::analysis::type::DoubleVector y_;
+  size_t size_;
+  size_t head_;
+  size_t count_;
+  /* Running means, sums of squared differences and sum of cross products
+     of the differences from the means */
+  double meanx_;
+  double meany_;
+  double m2x_;
+  double m2y_;
+  double cxy_;
+  /* Replacements since the running moments were last recalculated */
+  size_t replacements_;
+};
+
+} // namespace analysis
+} // namespace gos
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef GOS_ANALYSIS_DURATION_H_
+#define GOS_ANALYSIS_DURATION_H_
+
+#include <cstddef>
+
+#include <vector>
+
+namespace gos {
+namespace analysis {
+
+/* Window over the values of the last span of time instead of the last
+   number of values, so jitter and dropouts in the sampling do not change
+   what the statistics cover. The window holds the values with a time
+   greater than the time of the newest value minus the span. */
+class duration {
+public:
+  duration();
+
+  duration(const double& span);
+
+  /* Add value at time, throws if the time is NaN or decreases */
+  void add(const double& value, const double& time);
+
+  void set(const double& span);
+
+  const double& span() const;
+
+  size_t count() const;
+
+  void clear();
+
+  /* The value at index, where index 0 is the oldest value in the window */
+  const double& at(const size_t& index) const;
+
+  double sum() const;
+
+  const double& mean() const;
+
+  double variance() const;
+
+  double sd() const;
+
+private:
+  struct Item {
+    double Time;
+    double Value;
+  };
+
+  typedef ::std::vector<Item> ItemVector;
+
+  void evict(const double& time);
+  void grow();
+  void synchronize();
+  const Item& item(const size_t& index) const;
+
+  /* Circular buffer, the oldest value is at head_, doubled when full */
+  ItemVector items_;
+  double span_;
+  size_t head_;
+  size_t count_;
+  /* Running mean and sum of squared differences from the mean */
+  double mean_;
+  double m2_;
+  /* Removals since the running moments were last recalculated */
+  size_t removals_;
+};
+
+} // namespace analysis
+} // namespace gos
+
+#endif
@@ -13,7 +13,7 @@ public:
 #if _MSC_VER >= 1910
   const char* what() const noexcept override;
 #else
-  const char* what() const;
+  const char* what() const noexcept;
 #endif
 private:
   std::string what_;
@@ -0,0 +1,61 @@
+#ifndef GOS_ANALYSIS_EXPONENTIAL_H_
+#define GOS_ANALYSIS_EXPONENTIAL_H_
+
+#include <cstddef>
+
+namespace gos {
+namespace analysis {
+
+/* Exponentially weighted mean and variance, nothing is stored per sample.
+   The weight of a new sample is alpha, and the half-life is the number of
+   samples, or the time span for the time aware add, after which a sample
+   has lost half its weight. */
+class exponential {
+public:
+  exponential();
+
+  exponential(const double& alpha);
+
+  void setalpha(const double& alpha);
+
+  void sethalflife(const double& halflife);
+
+  const double& alpha() const;
+
+  double halflife() const;
+
+  /* Add a sample with the weight alpha, false if it is NaN, which is
+     never added */
+  bool add(const double& value);
+
+  /* Add a sample at time, the weight depends on the time since the
+     previous sample so irregular sampling is handled. False if the value
+     or the time is NaN, the sample is then skipped as if not taken. */
+  bool add(const double& value, const double& time);
+
+  size_t count() const;
+
+  void clear();
+
+  const double& mean() const;
+
+  const double& variance() const;
+
+  double sd() const;
+
+private:
+  void update(const double& value, const double& alpha);
+
+  double alpha_;
+  /* The decay rate per time unit, -ln(1 - alpha) */
+  double rate_;
+  double mean_;
+  double variance_;
+  double time_;
+  size_t count_;
+};
+
+} // namespace analysis
+} // namespace gos
+
+#endif
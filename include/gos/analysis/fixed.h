@@ -0,0 +1,208 @@
+#ifndef GOS_ANALYSIS_FIXED_H_
+#define GOS_ANALYSIS_FIXED_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <type_traits>
+
+namespace gos {
+namespace analysis {
+namespace fixed {
+
+/* Integer samples are accumulated exactly in 64 bits, floating point
+   samples in double */
+template<typename T> struct accumulator {
+  typedef typename ::std::conditional<
+    ::std::is_floating_point<T>::value,
+    double,
+    typename ::std::conditional<
+      ::std::is_signed<T>::value,
+      ::std::int64_t,
+      ::std::uint64_t>::type>::type type;
+};
+
+/* Window with the capacity known at compile time, the values are kept in a
+   circular buffer inside the object so nothing is allocated. The sum is
+   exact for integers, the variance is kept as running moments like window
+   and the values are also kept sorted, so every statistic is constant time
+   and an add shifts at most N values. NaN is never added. */
+template<typename T, ::std::size_t N> class window {
+  static_assert(N > 0, "The window size must be positive");
+  static_assert(::std::is_arithmetic<T>::value,
+    "The window sample type must be arithmetic");
+public:
+  typedef T value_type;
+  typedef typename accumulator<T>::type accumulator_type;
+  typedef ::std::array<T, N> Array;
+
+  window() :
+    head_(0),
+    count_(0),
+    replacements_(0),
+    sum_(0),
+    mean_(0.0),
+    m2_(0.0) {
+  }
+
+  static constexpr ::std::size_t size() {
+    return N;
+  }
+
+  /* Add a value, false if the value is NaN */
+  bool add(const T& value) {
+    if (value != value) {
+      return false;
+    }
+    double x = static_cast<double>(value);
+    if (count_ < N) {
+      array_[count_++] = value;
+      insert(value, count_ - 1);
+      sum_ += static_cast<accumulator_type>(value);
+      double delta = x - mean_;
+      mean_ += delta / static_cast<double>(count_);
+      m2_ += delta * (x - mean_);
+      return true;
+    }
+    T evicted = array_[head_];
+    array_[head_] = value;
+    if (++head_ >= N) {
+      head_ = 0;
+    }
+    /* Remove the evicted value from the sorted values and insert the new */
+    T* position = ::std::lower_bound(
+      sorted_.begin(), sorted_.begin() + N, evicted);
+    ::std::copy(position + 1, sorted_.begin() + N, position);
+    insert(value, N - 1);
+    if (++replacements_ >= N) {
+      synchronize();
+      return true;
+    }
+    sum_ += static_cast<accumulator_type>(value) -
+      static_cast<accumulator_type>(evicted);
+    double old = static_cast<double>(evicted);
+    double mean = mean_;
+    mean_ += (x - old) / static_cast<double>(N);
+    m2_ += (x - old) * (x - mean_ + old - mean);
+    return true;
+  }
+
+  void clear() {
+    head_ = 0;
+    count_ = 0;
+    replacements_ = 0;
+    sum_ = 0;
+    mean_ = 0.0;
+    m2_ = 0.0;
+  }
+
+  ::std::size_t count() const {
+    return count_;
+  }
+
+  bool full() const {
+    return count_ == N;
+  }
+
+  /* The value at index, where index 0 is the oldest value in the window */
+  const T& at(const ::std::size_t& index) const {
+    ::std::size_t position = head_ + index;
+    return array_[position >= N ? position - N : position];
+  }
+
+  /* The values in storage order, the first count() of them are valid */
+  const Array& array() const {
+    return array_;
+  }
+
+  /* The values in ascending order, the first count() of them are valid */
+  const Array& sorted() const {
+    return sorted_;
+  }
+
+  const accumulator_type& sum() const {
+    return sum_;
+  }
+
+  /* An empty window has a mean and median of 0 and a variance and sd of
+     NaN, as the runtime window */
+  double mean() const {
+    if (count_ == 0) {
+      return 0.0;
+    }
+    return static_cast<double>(sum_) / static_cast<double>(count_);
+  }
+
+  double variance() const {
+    if (count_ == 0) {
+      return ::std::numeric_limits<double>::quiet_NaN();
+    }
+    return ::std::max(m2_, 0.0) / static_cast<double>(count_);
+  }
+
+  double sd() const {
+    return ::sqrt(variance());
+  }
+
+  double median() const {
+    if (count_ == 0) {
+      return 0.0;
+    }
+    ::std::size_t medianindex = count_ / 2;
+    double median = static_cast<double>(sorted_[medianindex]);
+    if (count_ % 2 == 0) {
+      median += static_cast<double>(sorted_[medianindex - 1]);
+      median /= 2.0;
+    }
+    return median;
+  }
+
+private:
+  /* Insert value into the first used sorted values */
+  void insert(const T& value, const ::std::size_t& used) {
+    T* position = ::std::upper_bound(
+      sorted_.begin(), sorted_.begin() + used, value);
+    ::std::copy_backward(position, sorted_.begin() + used,
+      sorted_.begin() + used + 1);
+    *position = value;
+  }
+
+  /* Recalculate the sum and moments once per window length to bound the
+     rounding drift */
+  void synchronize() {
+    accumulator_type sum = 0;
+    for (::std::size_t i = 0; i < N; i++) {
+      sum += static_cast<accumulator_type>(array_[i]);
+    }
+    double mean = static_cast<double>(sum) / static_cast<double>(N);
+    double m2 = 0.0;
+    for (::std::size_t i = 0; i < N; i++) {
+      double diff = static_cast<double>(array_[i]) - mean;
+      m2 += diff * diff;
+    }
+    sum_ = sum;
+    mean_ = mean;
+    m2_ = m2;
+    replacements_ = 0;
+  }
+
+  Array array_;
+  Array sorted_;
+  ::std::size_t head_;
+  ::std::size_t count_;
+  ::std::size_t replacements_;
+  accumulator_type sum_;
+  /* Running mean and sum of squared differences from the mean */
+  double mean_;
+  double m2_;
+};
+
+} // namespace fixed
+} // namespace analysis
+} // namespace gos
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef GOS_ANALYSIS_FOPDT_H_
+#define GOS_ANALYSIS_FOPDT_H_
+
+#include <cstddef>
+
+#include <string>
+#include <vector>
+
+#include <gos/analysis/pool.h>
+#include <gos/analysis/tc.h>
+
+namespace gos {
+namespace analysis {
+namespace fopdt {
+
+/* First order plus dead time identification of the temperature response
+   to steps of the control, y = y0 + K du (1 - exp(-(t - theta) / tau))
+   after the dead time theta */
+
+struct Options {
+  Options();
+  /* The smallest change of the control that is a step */
+  double Threshold;
+  /* Changes of the control closer in seconds than this are one step, as a
+     ramp of the control up to a level */
+  double Merge;
+  /* The shortest response in seconds to fit */
+  double Minimum;
+  /* The seconds before a step averaged for the temperature at the step */
+  double Baseline;
+  /* The limit and the relative change of the squared error that stop the
+     Levenberg-Marquardt fit */
+  size_t Iterations;
+  double Tolerance;
+  /* The closed loop time constant of the IMC settings, zero for the larger
+     of tau / 10 and 0.8 theta */
+  double Lambda;
+};
+
+/* A step of the control at Time from Before to After, the response is the
+   rows in [Begin, End) up to the next step or the end of the run */
+struct Step {
+  Step();
+  size_t Begin;
+  size_t End;
+  double Time;
+  double Before;
+  double After;
+};
+
+typedef ::std::vector<Step> StepVector;
+
+struct Model {
+  Model();
+  double Gain;
+  double TimeConstant;
+  double DeadTime;
+  /* The temperature at the step */
+  double Offset;
+  /* The root mean square of the residuals */
+  double Error;
+  size_t Iterations;
+};
+
+/* Settings in the parallel form Kp e + Ki integral e + Kd de/dt of the
+   PID logs, in seconds */
+struct Settings {
+  Settings();
+  double Kp;
+  double Ki;
+  double Kd;
+};
+
+enum class Rule {
+  ZieglerNichols,
+  CohenCoon,
+  Imc
+};
+
+/* A fitted step of a run and the settings of every rule */
+struct Identification {
+  Identification();
+  ::std::string File;
+  Step Change;
+  Model Fit;
+  Settings ZieglerNichols;
+  Settings CohenCoon;
+  Settings Imc;
+  /* Empty unless the run could not be identified */
+  ::std::string Error;
+};
+
+typedef ::std::vector<Identification> IdentificationVector;
+
+/* The steps of the control with a response of at least Minimum seconds */
+void detect(
+  StepVector& steps,
+  const ::gos::analysis::tc::StandardVector& vector,
+  const Options& options);
+
+/* Fit the model to the response of the step by nonlinear least squares,
+   starting from the two point estimate at 28.3% and 63.2% of the rise.
+   Throws if the step has too few rows or no response. */
+Model fit(
+  const ::gos::analysis::tc::StandardVector& vector,
+  const Step& step,
+  const Options& options);
+
+/* The PID settings of the rule for the model, NaN for Ziegler-Nichols
+   and Cohen-Coon without a dead time */
+Settings tune(const Model& model, const Rule& rule, const double& lambda);
+
+/* Detect and fit every step of the run */
+void identify(
+  IdentificationVector& identifications,
+  const ::gos::analysis::tc::StandardVector& vector,
+  const Options& options);
+
+/* Identify the steps of the standard files on the pool, in the order of
+   the files. A file that fails gets one identification with the Error. */
+void identify(
+  IdentificationVector& identifications,
+  const ::std::vector<::std::string>& filepaths,
+  const Options& options,
+  ::gos::analysis::pool& pool = ::gos::analysis::pool::shared());
+
+} // namespace fopdt
+} // namespace analysis
+} // namespace gos
+
+#endif
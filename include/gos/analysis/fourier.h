@@ -0,0 +1,138 @@
+#ifndef GOS_ANALYSIS_FOURIER_H_
+#define GOS_ANALYSIS_FOURIER_H_
+
+#include <cstddef>
+
+#include <complex>
+#include <vector>
+
+#include <gos/analysis/pool.h>
+#include <gos/analysis/types.h>
+
+namespace gos {
+namespace analysis {
+namespace fourier {
+
+typedef ::std::complex<double> Complex;
+typedef ::std::vector<Complex> ComplexVector;
+
+/* The plan of a complex FFT of size points, the factors and twiddles are
+   computed once. Mixed radix Stockham stages of 4, 2, 3 and 5, any other
+   prime factor is a direct DFT of that size so sizes with large prime
+   factors are slow. A plan is used from any number of threads. */
+class plan {
+public:
+  plan(const size_t& size);
+  size_t size() const;
+  /* X[k] = sum x[j] exp(-2 pi i j k / n) in place, unnormalised as R fft(),
+     the inverse has the positive exponent */
+  void transform(Complex* data, const bool& inverse = false) const;
+  /* The plan of size shared by the library */
+  static const plan& cached(const size_t& size);
+private:
+  struct Stage {
+    size_t Radix;
+    size_t Span;
+    size_t Twiddles;
+  };
+  void stage(Complex* destination, const Complex* source, const Stage& stage)
+    const;
+  size_t size_;
+  ::std::vector<Stage> stages_;
+  /* exp(-2 pi i k / n) */
+  ComplexVector roots_;
+  ComplexVector twiddles_;
+};
+
+/* The plan of a FFT of size real points, a complex FFT of half the size
+   when the size is even */
+class realplan {
+public:
+  realplan(const size_t& size);
+  size_t size() const;
+  /* The size / 2 + 1 coefficients X[0] to X[n / 2] of the real input */
+  void forward(Complex* destination, const double* source) const;
+  static const realplan& cached(const size_t& size);
+private:
+  size_t size_;
+  const plan& complex_;
+  /* exp(-2 pi i k / n) for k <= n / 2 */
+  ComplexVector twiddles_;
+};
+
+enum class Window {
+  Rectangular,
+  Hann,
+  Hamming,
+  Blackman
+};
+
+/* The periodic window of size points */
+void taper(
+  ::gos::analysis::type::DoubleVector& window,
+  const size_t& size,
+  const Window& type);
+
+struct Options {
+  Options();
+  /* Points in a segment and points shared by consecutive segments */
+  size_t Segment;
+  size_t Overlap;
+  Window Taper;
+  /* Samples per second, resample an irregular log to a uniform grid first */
+  double Rate;
+  /* Subtract the mean of every segment */
+  bool Detrend;
+};
+
+/* The one sided power spectral density at Frequency[k] = k Rate / Segment
+   for k <= Segment / 2, in units squared per hertz */
+struct Spectrum {
+  Spectrum();
+  ::gos::analysis::type::DoubleVector Frequency;
+  ::gos::analysis::type::DoubleVector Power;
+  size_t Segments;
+};
+
+/* The density of every segment, Power[segment * Frequency.size() + k],
+   Time is the middle of the segment in seconds from the first value */
+struct Spectrogram {
+  ::gos::analysis::type::DoubleVector Frequency;
+  ::gos::analysis::type::DoubleVector Time;
+  ::gos::analysis::type::DoubleVector Power;
+};
+
+/* Welch's average of the periodograms of the overlapping tapered segments,
+   the segments are transformed on the pool. Throws if there are fewer
+   values than a segment. */
+void welch(
+  Spectrum& spectrum,
+  const double* values,
+  const size_t& count,
+  const Options& options,
+  ::gos::analysis::pool& pool = ::gos::analysis::pool::shared());
+
+void welch(
+  Spectrum& spectrum,
+  const ::gos::analysis::type::AlignedDoubleVector& column,
+  const Options& options,
+  ::gos::analysis::pool& pool = ::gos::analysis::pool::shared());
+
+void spectrogram(
+  Spectrogram& spectrogram,
+  const double* values,
+  const size_t& count,
+  const Options& options,
+  ::gos::analysis::pool& pool = ::gos::analysis::pool::shared());
+
+void spectrogram(
+  Spectrogram& spectrogram,
+  const ::gos::analysis::type::AlignedDoubleVector& column,
+  const Options& options,
+  ::gos::analysis::pool& pool = ::gos::analysis::pool::shared());
+
+} // namespace fourier
+} // namespace analysis
+} // namespace gos
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef GOS_ANALYSIS_JOIN_H_
+#define GOS_ANALYSIS_JOIN_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <limits>
+#include <vector>
+
+#include <gos/analysis/pool.h>
+
+namespace gos {
+namespace analysis {
+namespace join {
+
+/* Backward matches the last right time at or before the left time,
+   Forward the first right time at or after it and Nearest the closer of
+   the two, the earlier one on a tie */
+enum class Direction {
+  Backward,
+  Forward,
+  Nearest
+};
+
+/* The index of the matched right row for every left row, -1 for none */
+typedef ::std::vector<::std::int64_t> IndexVector;
+
+const ::std::int64_t None = -1;
+
+/* As-of join of two ascending time columns in one merge pass, O(n + m).
+   A match further than tolerance from the left time is no match. Throws
+   if a column is not sorted. */
+void asof(
+  IndexVector& matches,
+  const double* left,
+  const size_t& leftcount,
+  const double* right,
+  const size_t& rightcount,
+  const Direction& direction = Direction::Backward,
+  const double& tolerance = ::std::numeric_limits<double>::infinity());
+
+/* The same join with the left rows split in partitions merged in parallel
+   on the pool, every partition starts from a binary search of the right
+   times so the result is the same as the serial join */
+void asof(
+  IndexVector& matches,
+  const double* left,
+  const size_t& leftcount,
+  const double* right,
+  const size_t& rightcount,
+  const Direction& direction,
+  const double& tolerance,
+  ::gos::analysis::pool& pool);
+
+/* The right column aligned to the left rows, fill for a row without a
+   match */
+template<typename Destination, typename Source> void gather(
+  Destination& destination,
+  const Source& source,
+  const IndexVector& matches,
+  const typename Destination::value_type& fill =
+    ::std::numeric_limits<typename Destination::value_type>::quiet_NaN()) {
+  destination.resize(matches.size());
+  for (size_t i = 0; i < matches.size(); i++) {
+    destination[i] = matches[i] == None ?
+      fill : source[static_cast<size_t>(matches[i])];
+  }
+}
+
+} // namespace join
+} // namespace analysis
+} // namespace gos
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef GOS_ANALYSIS_MAPPING_H_
+#define GOS_ANALYSIS_MAPPING_H_
+
+#include <cstddef>
+
+namespace gos {
+namespace analysis {
+
+/* Read only memory mapping of a whole file */
+class mapping {
+public:
+  mapping(const char* filepath);
+
+  ~mapping();
+
+  mapping(const mapping&) = delete;
+  mapping& operator=(const mapping&) = delete;
+
+  const char* data() const;
+
+  const size_t& size() const;
+
+  const char* begin() const;
+
+  const char* end() const;
+
+private:
+  const char* data_;
+  size_t size_;
+#ifdef _WIN32
+  void* file_;
+  void* mapping_;
+#else
+  int file_;
+#endif
+};
+
+} // namespace analysis
+} // namespace gos
+
+#endif
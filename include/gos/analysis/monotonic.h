@@ -0,0 +1,82 @@
+#ifndef GOS_ANALYSIS_MONOTONIC_H_
+#define GOS_ANALYSIS_MONOTONIC_H_
+
+#include <cstddef>
+
+#include <functional>
+#include <vector>
+
+namespace gos {
+namespace analysis {
+
+/* Monotonic deque for rolling extremes. Every value is pushed with its
+   sequence number and the values that can never become the extreme are
+   dropped from the back, so push and evict are amortised constant time and
+   the extreme of the window is always at the front. The deque never holds
+   more values than the window, it is kept in a circular buffer of the
+   window capacity. Compare is std::less for the minimum and std::greater
+   for the maximum. */
+template<typename Compare> class monotonic {
+public:
+  monotonic() : head_(0), count_(0) {
+  }
+
+  void set(const ::std::size_t& capacity) {
+    items_.resize(capacity);
+    clear();
+  }
+
+  void clear() {
+    head_ = 0;
+    count_ = 0;
+  }
+
+  bool empty() const {
+    return count_ == 0;
+  }
+
+  void push(const double& value, const ::std::size_t& sequence) {
+    Compare compare;
+    while (count_ > 0 && !compare(item(count_ - 1).Value, value)) {
+      count_--;
+    }
+    if (count_ < items_.size()) {
+      item(count_++) = Item{ value, sequence };
+    }
+  }
+
+  /* Drop the values older than the oldest sequence still in the window */
+  void evict(const ::std::size_t& oldest) {
+    while (count_ > 0 && items_[head_].Sequence < oldest) {
+      if (++head_ >= items_.size()) {
+        head_ = 0;
+      }
+      count_--;
+    }
+  }
+
+  const double& front() const {
+    return items_[head_].Value;
+  }
+
+private:
+  struct Item {
+    double Value;
+    ::std::size_t Sequence;
+  };
+
+  Item& item(const ::std::size_t& index) {
+    ::std::size_t position = head_ + index;
+    return items_[position >= items_.size() ?
+      position - items_.size() : position];
+  }
+
+  ::std::vector<Item> items_;
+  ::std::size_t head_;
+  ::std::size_t count_;
+};
+
+} // namespace analysis
+} // namespace gos
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef GOS_ANALYSIS_ORDER_H_
+#define GOS_ANALYSIS_ORDER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+namespace gos {
+namespace analysis {
+
+/* Order statistic tree, a treap where every node knows the size of its
+   sub tree so selecting a value by rank is logarithmic. The nodes are kept
+   in a pool so no allocation is done once the capacity has been reserved.
+   NaN has no order, it is never inserted and never found by erase. */
+class order {
+public:
+  order();
+
+  void reserve(const size_t& capacity);
+
+  void insert(const double& value);
+
+  /* Remove one occurrence of value, false if value was not found */
+  bool erase(const double& value);
+
+  void clear();
+
+  size_t count() const;
+
+  /* The value with rank, where rank 0 is the lowest value */
+  const double& select(const size_t& rank) const;
+
+  /* The number of values lower than value */
+  size_t rank(const double& value) const;
+
+  /* The number of values lower than or equal to value */
+  size_t upper(const double& value) const;
+
+private:
+  typedef ::std::uint32_t Index;
+
+  struct Node {
+    double Value;
+    Index Left;
+    Index Right;
+    Index Size;
+    ::std::uint32_t Priority;
+  };
+
+  typedef ::std::vector<Node> NodeVector;
+  typedef ::std::vector<Index> IndexVector;
+
+  Index allocate(const double& value);
+  void update(const Index& index);
+  void split(Index index, const double& value, Index& left, Index& right);
+  Index merge(Index left, Index right);
+  Index erase(const Index& index, const double& value, bool& found);
+
+  NodeVector nodes_;
+  IndexVector free_;
+  Index root_;
+  ::std::uint32_t seed_;
+};
+
+} // namespace analysis
+} // namespace gos
+
+#endif
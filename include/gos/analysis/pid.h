@@ -0,0 +1,92 @@
+#ifndef GOS_ANALYSIS_PID_H_
+#define GOS_ANALYSIS_PID_H_
+
+#include <cstdint>
+
+#include <gos/analysis/text.h>
+#include <gos/analysis/schema.h>
+
+namespace gos {
+namespace analysis {
+namespace pid {
+
+/* The columns of the PID run logs in var/pid/csv */
+
+/* Empty in some logs */
+struct Time : schema::field<double, schema::Missing::Mask> {
+  static const char* name() { return "time"; }
+};
+
+struct Round : schema::field<::std::int32_t> {
+  static const char* name() { return "round"; }
+};
+
+struct Status : schema::field<::std::int32_t> {
+  static const char* name() { return "status"; }
+};
+
+struct Automatic : schema::field<::std::int32_t> {
+  static const char* name() { return "automatic"; }
+};
+
+struct Kp : schema::field<double> {
+  static const char* name() { return "kp"; }
+};
+
+struct Ki : schema::field<double> {
+  static const char* name() { return "ki"; }
+};
+
+struct Kd : schema::field<double> {
+  static const char* name() { return "kd"; }
+};
+
+struct Setpoint : schema::field<double> {
+  static const char* name() { return "setpoint"; }
+};
+
+struct Output : schema::field<double> {
+  static const char* name() { return "output"; }
+};
+
+/* Missing from the end of the lines of some logs */
+struct Temperature : schema::field<double, schema::Missing::NaN> {
+  static const char* name() { return "temperature"; }
+};
+
+struct Error : schema::field<double> {
+  static const char* name() { return "error"; }
+};
+
+struct Integral : schema::field<double> {
+  static const char* name() { return "integral"; }
+};
+
+struct Derivative : schema::field<double> {
+  static const char* name() { return "derivative"; }
+};
+
+/* A log of the rounds of a tuning run, as 200419a. The header of 200419a
+   names a status column the lines do not have, parse it with the names
+   of RoundColumns() instead of the header. */
+typedef schema::table<Time, Round, Kp, Ki, Output, Temperature> RoundLog;
+
+inline text::StringVector RoundColumns() {
+  return text::StringVector{
+    "time", "round", "kp", "ki", "output", "temperature" };
+}
+
+/* A log of a run switched between manual and automatic control, as
+   200413a */
+typedef schema::table<Time, Automatic, Setpoint, Output, Temperature, Error,
+  Integral, Derivative> AutomaticLog;
+
+/* A log of a run with the controller state, as 200414a */
+typedef schema::table<Time, Status, Kp, Ki, Kd, Setpoint, Output,
+  Temperature, Error, Integral, Derivative> ControllerLog;
+
+} // namespace pid
+} // namespace analysis
+} // namespace gos
+
+#endif
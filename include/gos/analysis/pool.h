@@ -0,0 +1,84 @@
+#ifndef GOS_ANALYSIS_POOL_H_
+#define GOS_ANALYSIS_POOL_H_
+
+#include <cstddef>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gos {
+namespace analysis {
+
+namespace detail {
+struct Queue;
+} // namespace detail
+
+/* Fixed size work stealing thread pool. Every worker has its own queue,
+   a task queued from a worker goes to the back of its queue and the worker
+   takes its newest task first, an idle worker steals the oldest task of
+   another worker. Tasks queued from other threads are spread over the
+   workers. */
+class pool {
+public:
+  typedef ::std::function<void()> Task;
+  typedef ::std::function<void(size_t)> IndexFunction;
+
+  /* One thread per hardware thread */
+  pool();
+
+  pool(const size_t& threads);
+
+  ~pool();
+
+  pool(const pool&) = delete;
+  pool& operator=(const pool&) = delete;
+
+  size_t size() const;
+
+  /* Queue function and get a future for its result */
+  template<typename Function>
+  ::std::future<typename ::std::invoke_result<Function>::type> submit(
+    Function function) {
+    typedef typename ::std::invoke_result<Function>::type Result;
+    ::std::shared_ptr<::std::packaged_task<Result()>> task =
+      ::std::make_shared<::std::packaged_task<Result()>>(function);
+    ::std::future<Result> future = task->get_future();
+    push([task]() { (*task)(); });
+    return future;
+  }
+
+  /* Call function for every index in [0, count) on the pool and wait for
+     all of them. The calling thread takes indexes too, so run can be
+     called from a task running on the pool, and only size() - 1 workers
+     join it so at most size() threads run the function. The first
+     exception thrown is rethrown here once all indexes are done. */
+  void run(const size_t& count, const IndexFunction& function);
+
+  /* The pool shared by the library */
+  static pool& shared();
+
+private:
+  void push(Task task);
+  bool take(const size_t& worker, Task& task);
+  void work(const size_t& worker);
+
+  ::std::vector<::std::unique_ptr<detail::Queue>> queues_;
+  ::std::vector<::std::thread> threads_;
+  ::std::atomic<size_t> pending_;
+  ::std::atomic<size_t> next_;
+  ::std::mutex mutex_;
+  ::std::condition_variable condition_;
+  bool stop_;
+};
+
+} // namespace analysis
+} // namespace gos
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef GOS_ANALYSIS_QUANTILE_H_
+#define GOS_ANALYSIS_QUANTILE_H_
+
+#include <gos/analysis/types.h>
+#include <gos/analysis/order.h>
+
+namespace gos {
+namespace analysis {
+
+/* Rolling quantiles over the last size values, every add is logarithmic in
+   the window size and so is every quantile */
+class quantile {
+public:
+  quantile();
+
+  quantile(const size_t& size);
+
+  /* Add a value, false if it is NaN, which is never added as it has no
+     rank */
+  bool add(const double& value);
+
+  void set(const size_t& size);
+
+  const size_t& size() const;
+
+  size_t count() const;
+
+  void clear();
+
+  /* The quantile for probability in [0, 1], interpolated linearly between
+     the closest ranks */
+  double value(const double& probability) const;
+
+  void values(
+    ::gos::analysis::type::DoubleVector& values,
+    const ::gos::analysis::type::DoubleVector& probabilities) const;
+
+  double median() const;
+
+  /* The median absolute deviation from the median */
+  double mad() const;
+
+private:
+  double distance(
+    const size_t& rank,
+    const double& median,
+    const size_t& lower) const;
+
+  /* Circular buffer, the oldest value is at head_ */
+  ::gos::analysis::type::DoubleVector buffer_;
+  ::gos::analysis::order order_;
+  size_t size_;
+  size_t head_;
+  size_t count_;
+};
+
+} // namespace analysis
+} // namespace gos
+
+#endif
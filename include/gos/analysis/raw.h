@@ -0,0 +1,55 @@
+#ifndef GOS_ANALYSIS_RAW_H_
+#define GOS_ANALYSIS_RAW_H_
+
+#include <cstddef>
+
+#include <gos/analysis/pool.h>
+
+namespace gos {
+namespace analysis {
+namespace tc {
+namespace raw {
+
+/* The columns of the raw logger file without a header, by default the
+   time in milliseconds in column 0, the control in column 2 and the
+   temperature in column 3 */
+struct Layout {
+  Layout();
+  size_t Time;
+  size_t Control;
+  size_t Temperature;
+  double TicksPerSecond;
+};
+
+/* Text writes the standard CSV format, Binary the binary cache format */
+enum class Output {
+  Text,
+  Binary
+};
+
+/* Convert a raw file, the time rebased to start at 0 in seconds. The raw
+   file is read in blocks and both outputs are written as it is converted,
+   the binary one through binary::writer. The destination is replaced only
+   when the whole file converted. Returns the number of rows. */
+size_t convert(
+  const char* rawpath,
+  const char* destinationpath,
+  const Output& output = Output::Text,
+  const Layout& layout = Layout());
+
+/* Convert every .csv file in the raw directory to a file with the same
+   stem in the destination directory, one file per task on the pool.
+   Returns the number of files. */
+size_t convertdirectory(
+  const char* rawdirectory,
+  const char* destinationdirectory,
+  const Output& output = Output::Text,
+  const Layout& layout = Layout(),
+  ::gos::analysis::pool& pool = ::gos::analysis::pool::shared());
+
+} // namespace raw
+} // namespace tc
+} // namespace analysis
+} // namespace gos
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef GOS_ANALYSIS_RESAMPLE_H_
+#define GOS_ANALYSIS_RESAMPLE_H_
+
+#include <cstddef>
+
+#include <gos/analysis/tc.h>
+
+namespace gos {
+namespace analysis {
+namespace resample {
+
+/* Linear interpolates between the samples around a grid time, NaN outside
+   the samples. Previous takes the last sample at or before it, NaN before
+   the first sample. Mean averages the samples in the bin from the grid
+   time to the next one, NaN for an empty bin, and the samples outside
+   the grid are in no bin. */
+enum class Mode {
+  Linear,
+  Previous,
+  Mean
+};
+
+/* The uniform times Start + i * Step for i < Count */
+struct Grid {
+  double at(const size_t& index) const;
+  double Start;
+  double Step;
+  size_t Count;
+};
+
+/* The grid of multiples of step covering the times, within the first and
+   last time for Linear and Previous and the bins holding them for Mean.
+   Throws if step is not positive, the times are not ascending and finite
+   or the grid would have more points than a size_t holds. */
+Grid grid(
+  const double* time,
+  const size_t& count,
+  const double& step,
+  const Mode& mode);
+
+/* Resample the columns sharing the time column onto the grid, where to
+   take every grid value from is found once for all the columns. Every
+   destination holds grid.Count values. */
+void resample(
+  double* const* destinations,
+  const double* const* columns,
+  const size_t& width,
+  const double* time,
+  const size_t& count,
+  const Grid& grid,
+  const Mode& mode);
+
+/* Resample the control and temperature of the frame onto a grid of step,
+   the destination is replaced */
+void resample(
+  ::gos::analysis::tc::StandardFrame& destination,
+  const ::gos::analysis::tc::StandardFrame& source,
+  const double& step,
+  const Mode& mode = Mode::Linear);
+
+} // namespace resample
+} // namespace analysis
+} // namespace gos
+
+#endif
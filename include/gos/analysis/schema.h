@@ -0,0 +1,314 @@
+#ifndef GOS_ANALYSIS_SCHEMA_H_
+#define GOS_ANALYSIS_SCHEMA_H_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gos/analysis/exception.h>
+#include <gos/analysis/mapping.h>
+#include <gos/analysis/text.h>
+
+namespace gos {
+namespace analysis {
+namespace schema {
+
+/* What a field does when its value is empty, when the line ends before
+   it or when the file has no such column. Reject throws, Default stores
+   the fallback of the field, NaN stores a quiet NaN and Mask stores the
+   fallback and clears the mask of the row. */
+enum class Missing {
+  Reject,
+  Default,
+  NaN,
+  Mask
+};
+
+/* The base of a field of a schema, a field derives from it and adds a
+   static name() with the name of the column in the header
+
+   struct Time : field<double, Missing::Mask> {
+     static const char* name() { return "time"; }
+   }; */
+template<typename T, Missing M = Missing::Reject> struct field {
+  static_assert(::std::is_arithmetic<T>::value,
+    "The field type must be arithmetic");
+  static_assert(M != Missing::NaN || ::std::is_floating_point<T>::value,
+    "Only a floating point field can store NaN when missing");
+  typedef T type;
+  static constexpr Missing missing = M;
+  static T fallback() {
+    return M == Missing::NaN ? ::std::numeric_limits<T>::quiet_NaN() : T();
+  }
+};
+
+/* One byte per row, 1 where the value was present */
+typedef ::std::vector<::std::uint8_t> Mask;
+
+namespace detail {
+
+template<typename Field, typename... Fields> struct index;
+
+template<typename Field, typename... Rest>
+struct index<Field, Field, Rest...> :
+  ::std::integral_constant<::std::size_t, 0> {
+};
+
+template<typename Field, typename First, typename... Rest>
+struct index<Field, First, Rest...> :
+  ::std::integral_constant<::std::size_t,
+    1 + index<Field, Rest...>::value> {
+};
+
+/* Integers must be whole numbers in the range of the type */
+template<typename T> bool convert(
+  const char*& cursor,
+  const char* last,
+  T& value) {
+  double number;
+  if (!::gos::analysis::text::number(cursor, last, number)) {
+    return false;
+  }
+  if (::std::is_integral<T>::value && (
+    ::std::floor(number) != number ||
+    number < static_cast<double>(::std::numeric_limits<T>::lowest()) ||
+    number > static_cast<double>(::std::numeric_limits<T>::max()))) {
+    return false;
+  }
+  value = static_cast<T>(number);
+  return true;
+}
+
+inline void fail(const char* what, const char* name) {
+  ::std::string message(what);
+  message += name;
+  throw ::gos::analysis::exception(message.c_str());
+}
+
+} // namespace detail
+
+/* Columns of a delimited file with a header as a structure of arrays, the
+   parse code for every field is generated from the field list. The columns
+   are matched by name so their order in the file does not matter and the
+   columns not in the schema are skipped. */
+template<typename... Fields> class table {
+  static_assert(sizeof...(Fields) > 0, "The schema must have a field");
+public:
+  typedef ::std::tuple<::std::vector<typename Fields::type>...> Columns;
+
+  table() : size_(0) {
+  }
+
+  static constexpr ::std::size_t width() {
+    return sizeof...(Fields);
+  }
+
+  ::std::size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  void clear() {
+    truncate(0);
+  }
+
+  void reserve(const ::std::size_t& size) {
+    reserve(size, ::std::index_sequence_for<Fields...>());
+  }
+
+  template<typename Field>
+  const ::std::vector<typename Field::type>& column() const {
+    return ::std::get<detail::index<Field, Fields...>::value>(columns_);
+  }
+
+  /* The mask of a Missing::Mask field, empty for the other fields */
+  template<typename Field> const Mask& mask() const {
+    return masks_[detail::index<Field, Fields...>::value];
+  }
+
+  /* Append the rows of the file */
+  void parse(const char* filepath) {
+    ::gos::analysis::mapping mapping(filepath);
+    parse(mapping.begin(), mapping.end());
+  }
+
+  /* Append the rows of the file with names for the columns instead of the
+     names in the header, for a file with a wrong header */
+  void parse(
+    const char* filepath,
+    const ::gos::analysis::text::StringVector& names) {
+    ::gos::analysis::mapping mapping(filepath);
+    parse(mapping.begin(), mapping.end(), names);
+  }
+
+  /* Append the rows of the text, which starts with the header. Nothing is
+     appended if the text is not valid. */
+  void parse(const char* first, const char* last) {
+    const char* header = ::gos::analysis::text::end(first, last);
+    if (header == first) {
+      throw ::gos::analysis::exception("The schema file has no header");
+    }
+    ::gos::analysis::text::StringVector names;
+    ::gos::analysis::text::split(names, first, header);
+    parse(first, last, names);
+  }
+
+  void parse(
+    const char* first,
+    const char* last,
+    const ::gos::analysis::text::StringVector& names) {
+    namespace text = ::gos::analysis::text;
+    /* The field of every column up to the last one needed, -1 for a
+       column not in the schema */
+    ::std::vector<int> roles;
+    ::std::vector<int> absent;
+    const char* fields[] = { Fields::name()... };
+    const Missing missing[] = { Fields::missing... };
+    for (::std::size_t i = 0; i < width(); i++) {
+      int column = text::find(names, fields[i]);
+      if (column < 0) {
+        if (missing[i] == Missing::Reject) {
+          detail::fail("Missing the column ", fields[i]);
+        }
+        absent.push_back(static_cast<int>(i));
+      } else {
+        if (static_cast<::std::size_t>(column) >= roles.size()) {
+          roles.resize(static_cast<::std::size_t>(column) + 1, -1);
+        }
+        roles[static_cast<::std::size_t>(column)] = static_cast<int>(i);
+      }
+    }
+    const Cell* cells = table::cells(::std::index_sequence_for<Fields...>());
+    const char* cursor = text::next(first, last);
+    ::std::size_t size = size_;
+    reserve(size_ + text::lines(cursor, last) + 1);
+    try {
+      while (cursor < last) {
+        const char* lineend = text::end(cursor, last);
+        const char* field = cursor;
+        cursor = lineend < last ? text::next(lineend, last) : last;
+        if (field == lineend) {
+          continue;
+        }
+        for (::std::size_t c = 0; c < roles.size(); c++) {
+          /* A field of only blanks is missing like an empty one */
+          while (field < lineend && (*field == ' ' || *field == '\t')) {
+            field++;
+          }
+          bool present = field < lineend && *field != ',';
+          int role = roles[c];
+          if (role >= 0) {
+            cells[role](*this, field, lineend, present);
+          } else if (present) {
+            const char* delimiter = static_cast<const char*>(
+              ::std::memchr(field, ',', static_cast<::std::size_t>(
+                lineend - field)));
+            field = delimiter != nullptr ? delimiter : lineend;
+          }
+          if (field < lineend) {
+            field++;
+          }
+        }
+        for (int role : absent) {
+          cells[role](*this, field, lineend, false);
+        }
+        size_++;
+      }
+    } catch (...) {
+      truncate(size);
+      throw;
+    }
+  }
+
+private:
+  typedef void (*Cell)(
+    table& table,
+    const char*& cursor,
+    const char* last,
+    const bool& present);
+
+  /* Parse the value of field I at cursor, which is left at the delimiter */
+  template<::std::size_t I> static void cell(
+    table& table,
+    const char*& cursor,
+    const char* last,
+    const bool& present) {
+    typedef typename ::std::tuple_element<I, ::std::tuple<Fields...>>::type
+      Field;
+    typedef typename Field::type T;
+    ::std::vector<T>& column = ::std::get<I>(table.columns_);
+    if (present) {
+      T value;
+      if (!detail::convert(cursor, last, value) ||
+        (cursor < last && *cursor != ',')) {
+        detail::fail("Invalid number in the column ", Field::name());
+      }
+      column.push_back(value);
+      if (Field::missing == Missing::Mask) {
+        table.masks_[I].push_back(1);
+      }
+    } else {
+      if (Field::missing == Missing::Reject) {
+        detail::fail("Missing a value in the column ", Field::name());
+      }
+      column.push_back(Field::fallback());
+      if (Field::missing == Missing::Mask) {
+        table.masks_[I].push_back(0);
+      }
+    }
+  }
+
+  template<::std::size_t... I>
+  static const Cell* cells(::std::index_sequence<I...>) {
+    static const Cell result[] = { &table::template cell<I>... };
+    return result;
+  }
+
+  template<::std::size_t... I>
+  void reserve(const ::std::size_t& size, ::std::index_sequence<I...>) {
+    const Missing missing[] = { Fields::missing... };
+    for (::std::size_t i = 0; i < width(); i++) {
+      if (missing[i] == Missing::Mask) {
+        masks_[i].reserve(size);
+      }
+    }
+    (::std::get<I>(columns_).reserve(size), ...);
+  }
+
+  void truncate(const ::std::size_t& size) {
+    truncate(size, ::std::index_sequence_for<Fields...>());
+  }
+
+  template<::std::size_t... I>
+  void truncate(const ::std::size_t& size, ::std::index_sequence<I...>) {
+    (::std::get<I>(columns_).resize(
+      ::std::min(::std::get<I>(columns_).size(), size)), ...);
+    for (Mask& mask : masks_) {
+      mask.resize(::std::min(mask.size(), size));
+    }
+    size_ = size;
+  }
+
+  Columns columns_;
+  ::std::array<Mask, sizeof...(Fields)> masks_;
+  ::std::size_t size_;
+};
+
+} // namespace schema
+} // namespace analysis
+} // namespace gos
+
+#endif
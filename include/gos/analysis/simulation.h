@@ -0,0 +1,99 @@
+#ifndef GOS_ANALYSIS_SIMULATION_H_
+#define GOS_ANALYSIS_SIMULATION_H_
+
+#include <cstddef>
+
+#include <vector>
+
+#include <gos/analysis/fopdt.h>
+#include <gos/analysis/pool.h>
+
+namespace gos {
+namespace analysis {
+namespace simulation {
+
+/* A discrete ARX plant of the temperature, in deviations from Offset,
+   y[k] = sum A[i] y[k - 1 - i] + sum B[j] u[k - 1 - Delay - j] */
+struct Plant {
+  Plant();
+  ::std::vector<double> A;
+  ::std::vector<double> B;
+  size_t Delay;
+  /* The temperature at rest with the control at zero */
+  double Offset;
+};
+
+/* The plant of the model sampled every step seconds with a zero order
+   hold, the dead time is rounded to whole samples. The model offset is
+   the temperature with the control at before, the control before the
+   step, so the plant offset is moved back to the control at zero. */
+Plant discretize(
+  const ::gos::analysis::fopdt::Model& model,
+  const double& before,
+  const double& step);
+
+/* The plant of the fit of the identified step */
+Plant discretize(
+  const ::gos::analysis::fopdt::Identification& identification,
+  const double& step);
+
+struct Options {
+  Options();
+  /* Seconds between samples and the samples of a run from rest */
+  double Step;
+  size_t Samples;
+  double Setpoint;
+  /* The saturation of the control */
+  double Minimum;
+  double Maximum;
+  /* The settling band as a fraction of the change from Offset to the
+     setpoint */
+  double Band;
+};
+
+typedef ::gos::analysis::fopdt::Settings Gains;
+typedef ::std::vector<Gains> GainsVector;
+
+/* IAE and ISE integrate the error over the run. Overshoot is the largest
+   excursion past the setpoint as a fraction of the change and Settling the
+   seconds after which the temperature stays in the band, infinity when
+   it is out of the band at the end. */
+struct Score {
+  Score();
+  double Iae;
+  double Ise;
+  double Overshoot;
+  double Settling;
+};
+
+typedef ::std::vector<Score> ScoreVector;
+
+/* Run the PID with the gains against the plant from rest. The PID has
+   conditional integration when saturated and its derivative on the
+   temperature so the setpoint step does not kick it. */
+Score simulate(
+  const Plant& plant,
+  const Gains& gains,
+  const Options& options);
+
+/* Score every candidate on the pool, blocks of candidates run in the
+   lanes of vectorised loops */
+void simulate(
+  ScoreVector& scores,
+  const Plant& plant,
+  const GainsVector& candidates,
+  const Options& options,
+  ::gos::analysis::pool& pool = ::gos::analysis::pool::shared());
+
+/* Every combination of the gains, kd varying fastest */
+void grid(
+  GainsVector& candidates,
+  const ::std::vector<double>& kp,
+  const ::std::vector<double>& ki,
+  const ::std::vector<double>& kd);
+
+} // namespace simulation
+} // namespace analysis
+} // namespace gos
+
+#endif
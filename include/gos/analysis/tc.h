@@ -1,8 +1,16 @@
 #ifndef GOS_ANALYSIS_TC_H_
 #define GOS_ANALYSIS_TC_H_
 
+#include <cstdint>
+#include <cstdio>
+
 #include <vector>
 
+#include <gos/analysis/types.h>
+#include <gos/analysis/exponential.h>
+#include <gos/analysis/duration.h>
+#include <gos/analysis/window.h>
+
 namespace gos {
 namespace analysis {
 namespace tc {
@@ -19,14 +27,205 @@ struct Standard {
 
 typedef ::std::vector<Standard> StandardVector;
 
+/* The standard data as separate contiguous and aligned columns */
+struct StandardFrame {
+  typedef ::gos::analysis::type::AlignedDoubleVector Column;
+  size_t size() const;
+  bool empty() const;
+  void reserve(const size_t& size);
+  void resize(const size_t& size);
+  void clear();
+  void emplace_back(
+    const double& time,
+    const double& control,
+    const double& temperature);
+  void push_back(const Standard& standard);
+  Standard row(const size_t& index) const;
+  Column Time;
+  Column Control;
+  Column Temperature;
+};
+
+void convert(StandardFrame& frame, const StandardVector& vector);
+
+void convert(StandardVector& vector, const StandardFrame& frame);
+
+/* Opt in compact row of 8 bytes instead of 24, the time in ticks of a
+   millisecond, the control as an integer from 0 to 255 and the temperature
+   in quarter degrees */
+struct Compact {
+  static const ::std::uint32_t TicksPerSecond = 1000;
+  static const ::std::int32_t StepsPerDegree = 4;
+  double time() const;
+  double control() const;
+  double temperature() const;
+  ::std::uint32_t Time;
+  ::std::int16_t Temperature;
+  ::std::uint8_t Control;
+  ::std::uint8_t Reserved;
+};
+
+typedef ::std::vector<Compact> CompactVector;
+
+/* True if the row converts to a compact row and back without loss */
+bool fits(const Standard& standard);
+
+/* Throws if a row does not fit, compact is then left unchanged */
+void convert(CompactVector& compact, const StandardVector& vector);
+
+void convert(CompactVector& compact, const StandardFrame& frame);
+
+void convert(StandardVector& vector, const CompactVector& compact);
+
+/* Rolling covariance and correlation coefficient at Time */
+struct Correlation {
+  double Time;
+  double Covariance;
+  double Coefficient;
+};
+
+typedef ::std::vector<Correlation> CorrelationVector;
+
+/* How parse reads the file, Stream reads buffered through the CSV reader,
+   Mapped scans a memory mapping of the file in place, Parallel scans
+   chunks of the mapping on the shared thread pool and Cached loads the
+   binary cache next to the file, parsing and writing it when missing.
+   Cached writes next to the data so it is never the default. */
+enum class Parser {
+  Stream,
+  Mapped,
+  Parallel,
+  Cached
+};
+
+/* Pull based reader of a standard file in batches of rows, the file is
+   read in fixed size blocks so the memory used does not depend on the
+   size of the file */
+class reader {
+public:
+  reader(const char* filepath, const size_t& batchsize = 65536);
+
+  ~reader();
+
+  reader(const reader&) = delete;
+  reader& operator=(const reader&) = delete;
+
+  /* Replace batch with the next rows, false when there are no more */
+  bool next(StandardVector& batch);
+
+  bool next(StandardFrame& batch);
+
+  const size_t& batchsize() const;
+
+  /* The number of rows read so far */
+  const size_t& count() const;
+
+private:
+  template<typename Batch> bool read(Batch& batch);
+  bool fill();
+
+  ::std::FILE* file_;
+  ::std::vector<char> buffer_;
+  ::std::vector<int> roles_;
+  size_t begin_;
+  size_t end_;
+  size_t batchsize_;
+  size_t count_;
+  bool eof_;
+};
+
+/* The spread of the temperature window compared with the filter threshold */
+enum class Criterion {
+  StandardDeviation,
+  MedianAbsoluteDeviation,
+  PeakToPeak
+};
+
 void parse(StandardVector& vector, const char* filepath);
 
+void parse(
+  StandardVector& vector,
+  const char* filepath,
+  const Parser& parser);
+
+void parse(
+  StandardFrame& frame,
+  const char* filepath,
+  const Parser& parser = Parser::Mapped);
+
+/* Keep the rows where the criterion over the window ending at the row is
+   below the threshold. An empty window, as with a window size of 0, keeps
+   no rows in every overload. */
 void filter(
   StandardVector& destination,
   const StandardVector& source,
   const size_t& windowsize,
   const double& sdthreshold);
 
+void filter(
+  StandardVector& destination,
+  const StandardVector& source,
+  const size_t& windowsize,
+  const double& threshold,
+  const Criterion& criterion);
+
+/* Filter a batch, the window carries the state from one batch to the
+   next so filtering a file batch by batch gives the same result as
+   filtering it all at once */
+void filter(
+  StandardVector& destination,
+  const StandardVector& batch,
+  ::gos::analysis::window& window,
+  const double& sdthreshold);
+
+/* Filter all the batches left in the reader */
+void filter(
+  StandardVector& destination,
+  reader& reader,
+  const size_t& windowsize,
+  const double& sdthreshold);
+
+/* Filter a frame, only the temperature column is read for the criterion */
+void filter(
+  StandardFrame& destination,
+  const StandardFrame& source,
+  const size_t& windowsize,
+  const double& sdthreshold);
+
+/* Filter compact rows, the window sums of the quarter degrees and of their
+   squares are exact 64 bit integers so they never drift */
+void filter(
+  CompactVector& destination,
+  const CompactVector& source,
+  const size_t& windowsize,
+  const double& sdthreshold);
+
+/* Filter on the exponentially weighted temperature standard deviation,
+   the samples are weighted by the time since the previous sample */
+void filter(
+  StandardVector& destination,
+  const StandardVector& source,
+  const ::gos::analysis::exponential& exponential,
+  const double& sdthreshold);
+
+/* Filter on the temperature standard deviation over the last span seconds
+   instead of a number of samples. Named apart from filter as a span would
+   be ambiguous with a window size. Throws if the times decrease. */
+void filterspan(
+  StandardVector& destination,
+  const StandardVector& source,
+  const double& span,
+  const double& sdthreshold);
+
+/* Rolling covariance and correlation between the control and the
+   temperature lag samples later, in one pass over the source. There is one
+   result for every source sample from lag on, at the temperature time. */
+void correlate(
+  CorrelationVector& destination,
+  const StandardVector& source,
+  const size_t& windowsize,
+  const size_t& lag = 0);
+
 } // namespace tc
 } // namespace analysis
 } // namespace gos
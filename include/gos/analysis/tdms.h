@@ -0,0 +1,103 @@
+#ifndef GOS_ANALYSIS_TDMS_H_
+#define GOS_ANALYSIS_TDMS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#include <gos/analysis/types.h>
+#include <gos/analysis/mapping.h>
+#include <gos/analysis/tc.h>
+
+namespace gos {
+namespace analysis {
+namespace tdms {
+
+/* The TDMS data types that can be read as numbers */
+enum class Type : ::std::uint32_t {
+  Void = 0x00,
+  Int8 = 0x01,
+  Int16 = 0x02,
+  Int32 = 0x03,
+  Int64 = 0x04,
+  UInt8 = 0x05,
+  UInt16 = 0x06,
+  UInt32 = 0x07,
+  UInt64 = 0x08,
+  Single = 0x09,
+  Double = 0x0A,
+  SingleWithUnit = 0x19,
+  DoubleWithUnit = 0x1A,
+  String = 0x20,
+  Boolean = 0x21,
+  Timestamp = 0x44
+};
+
+/* Values of a channel in the data file, Count values Stride bytes apart
+   from Offset, repeated Repeat times Step bytes apart */
+struct Chunk {
+  ::std::uint64_t Offset;
+  ::std::uint64_t Count;
+  ::std::uint64_t Stride;
+  ::std::uint64_t Repeat;
+  ::std::uint64_t Step;
+  bool BigEndian;
+};
+
+typedef ::std::vector<Chunk> ChunkVector;
+
+struct Channel {
+  ::std::string Group;
+  ::std::string Name;
+  Type DataType;
+  ::std::uint64_t Count;
+  ChunkVector Chunks;
+};
+
+typedef ::std::vector<Channel> ChannelVector;
+
+/* A TDMS file with its metadata, the segment lead-ins and metadata are
+   read from the .tdms_index next to the file when there is one, otherwise
+   from the file itself seeking past the raw data. The data file is mapped
+   and values are only read when a channel is read. */
+class file {
+public:
+  file(const char* filepath);
+
+  file(const file&) = delete;
+  file& operator=(const file&) = delete;
+
+  const ChannelVector& channels() const;
+
+  /* The index of the channel or -1 if not found */
+  int find(const char* group, const char* name) const;
+
+  /* The index of the first channel with the name in any group or -1 */
+  int find(const char* name) const;
+
+  /* The values in place in the mapping when the channel is stored as one
+   contiguous run of doubles in the byte order of the machine, otherwise
+   nullptr */
+  const double* view(const size_t& channel) const;
+
+  /* Append the values of the channel converted to double */
+  void read(
+    ::gos::analysis::type::AlignedDoubleVector& column,
+    const size_t& channel) const;
+
+private:
+  ::gos::analysis::mapping mapping_;
+  ChannelVector channels_;
+};
+
+/* Append the time, control and temperature channels of the file to the
+   frame, the channels are found by name in any group */
+void read(::gos::analysis::tc::StandardFrame& frame, const file& file);
+
+} // namespace tdms
+} // namespace analysis
+} // namespace gos
+
+#endif
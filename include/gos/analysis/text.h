@@ -0,0 +1,50 @@
+#ifndef GOS_ANALYSIS_TEXT_H_
+#define GOS_ANALYSIS_TEXT_H_
+
+#include <cstddef>
+
+#include <string>
+#include <vector>
+
+namespace gos {
+namespace analysis {
+namespace text {
+
+typedef ::std::vector<::std::string> StringVector;
+
+/* The number of line feeds in the text */
+size_t lines(const char* first, const char* last);
+
+/* The start of the next line, last if there is none */
+const char* next(const char* first, const char* last);
+
+/* The end of the current line, before any carriage return */
+const char* end(const char* first, const char* last);
+
+/* Split a delimited line into trimmed fields */
+void split(
+  StringVector& fields,
+  const char* first,
+  const char* last,
+  const char& delimiter = ',');
+
+/* The index of name in the fields or -1 if not found */
+int find(const StringVector& fields, const char* name);
+
+/* Convert the number at cursor and move cursor past it and the blanks
+   after it. False, with the cursor not moved, if there is no number at
+   cursor or it is followed by anything but the delimiter or last. */
+bool number(
+  const char*& cursor,
+  const char* last,
+  double& value,
+  const char& delimiter = ',');
+
+/* Move cursor past the next delimiter on the line, false at end of line */
+bool skip(const char*& cursor, const char* last, const char& delimiter = ',');
+
+} // namespace text
+} // namespace analysis
+} // namespace gos
+
+#endif
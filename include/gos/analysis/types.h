@@ -5,6 +5,8 @@
 
 #include <vector>
 
+#include <gos/analysis/aligned.h>
+
 namespace gos {
 namespace analysis {
 namespace type {
@@ -13,6 +15,7 @@ typedef ::std::pair<double, double> Range;
 typedef ::std::vector<double> DoubleVector;
 typedef DoubleVector::iterator DoubleIterator;
 typedef DoubleVector::size_type DoubleSize;
+typedef ::std::vector<double, aligned::allocator<double>> AlignedDoubleVector;
 
 Range make_range(const double& lowest, const double& highest);
 
@@ -4,19 +4,45 @@
 #include <memory>
 
 #include <gos/analysis/types.h>
+#include <gos/analysis/order.h>
+#include <gos/analysis/monotonic.h>
 
 namespace gos {
 namespace analysis {
 
+/* What window does with a value outside of the range, NaN is outside of
+   any range and is counted as an outlier but never added */
+enum class RangePolicy {
+  /* The value is not added */
+  Reject,
+  /* The value is clamped to the range and added */
+  Clamp,
+  /* The value is added as is and only counted */
+  Outlier
+};
+
 class window {
 public:
   window();
 
   window(const size_t& size);
 
-  void setrange(const double& lowest, const double& highest);
+  void setrange(
+    const double& lowest,
+    const double& highest,
+    const RangePolicy& policy = RangePolicy::Reject);
+
+  /* Add a value, false if the value was rejected by the range or is NaN,
+     which is never added */
+  bool add(const double& value);
 
-  void add(const double& value);
+  /* Add count values, the range check and the statistics run over the
+     whole batch at once. NaN is dropped as by add. Returns the number of
+     values added. */
+  size_t add(const double* first, const size_t& count);
+
+  /* The number of values added or offered outside of the range */
+  const size_t& outliers() const;
 
   void set(const size_t& size);
 
@@ -24,29 +50,71 @@ public:
 
   size_t count() const;
 
+  /* The value at index, where index 0 is the oldest value in the window */
+  const double& at(const size_t& index) const;
+
+  /* The values ordered from the oldest to the newest */
   const ::gos::analysis::type::DoubleVector& vector() const;
   
   const double& sum() const;
 
   void clear();
 
+  /* An empty window has a mean, median and extremes of 0 and a variance
+     and sd of NaN */
   double mean() const;
 
-  double median();
+  double median() const;
 
   double variance() const;
 
   double sd() const;
 
+  double minimum() const;
+
+  double maximum() const;
+
+  /* The difference between the maximum and the minimum */
+  double peaktopeak() const;
+
 private:
+  void push(const double& value);
+  void bulk(const double* first, const size_t& count);
+  void synchronize();
+  void track() const;
+  void extremes() const;
+
   typedef std::unique_ptr<::gos::analysis::type::Range> RangePointer;
-  ::gos::analysis::type::DoubleVector vector_;
+  /* Circular buffer, the oldest value is at head_ */
+  ::gos::analysis::type::DoubleVector buffer_;
+  mutable ::gos::analysis::type::DoubleVector vector_;
+  mutable bool ordered_;
   RangePointer range_;
+  RangePolicy policy_;
+  size_t outliers_;
+  ::gos::analysis::type::DoubleVector scratch_;
   size_t size_;
+  size_t head_;
+  size_t count_;
   double sum_;
+  /* Running mean and sum of squared differences from the mean */
+  double mean_;
+  double m2_;
+  /* Replacements since the running moments were last recalculated */
+  size_t replacements_;
+  /* The values in order, only maintained once an order statistic has been
+     requested */
+  mutable ::gos::analysis::order order_;
+  mutable bool tracking_;
+  /* Monotonic deques for the extremes, only maintained once an extreme has
+     been requested, sequence_ is the number of values added so far */
+  mutable ::gos::analysis::monotonic<std::less<double>> minimum_;
+  mutable ::gos::analysis::monotonic<std::greater<double>> maximum_;
+  mutable bool extremes_;
+  size_t sequence_;
 };
 } // namespace analysis
 } // namespace gos
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,174 @@
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gos/analysis/batch.h>
+#include <gos/analysis/pool.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+namespace fs = ::std::filesystem;
+
+static void usage();
+static bool number(const char* text, double& value);
+static bool integer(const char* text, size_t& value);
+static bool match(const char* pattern, const char* name);
+static void expand(std::vector<std::string>& filepaths, const char* argument);
+
+int main(int argc, char* argv[]) {
+  ga::batch::Options options;
+  const char* output = nullptr;
+  size_t threads = 0;
+  std::vector<std::string> filepaths;
+  for (int i = 1; i < argc; i++) {
+    const char* argument = argv[i];
+    double value;
+    bool valued = i + 1 < argc;
+    if (::strcmp(argument, "--window") == 0 && valued) {
+      if (!integer(argv[++i], options.WindowSize) || options.WindowSize < 1) {
+        usage();
+        return EXIT_FAILURE;
+      }
+    } else if (::strcmp(argument, "--threshold") == 0 && valued) {
+      if (!number(argv[++i], options.Threshold)) {
+        usage();
+        return EXIT_FAILURE;
+      }
+    } else if (::strcmp(argument, "--limit") == 0 && valued) {
+      if (!number(argv[++i], value) || value < 0) {
+        usage();
+        return EXIT_FAILURE;
+      }
+      options.Limit = static_cast<std::uint64_t>(value * (1 << 20));
+    } else if (::strcmp(argument, "--threads") == 0 && valued) {
+      if (!integer(argv[++i], threads) || threads < 1) {
+        usage();
+        return EXIT_FAILURE;
+      }
+    } else if (::strcmp(argument, "--output") == 0 && valued) {
+      output = argv[++i];
+    } else if (argument[0] == '-' && argument[1] == '-') {
+      usage();
+      return EXIT_FAILURE;
+    } else {
+      expand(filepaths, argument);
+    }
+  }
+  if (filepaths.empty()) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  ga::batch::SummaryVector summaries;
+  size_t failed = 0;
+  try {
+    if (threads > 0) {
+      /* The calling thread works with threads - 1 of the workers */
+      ga::pool pool(threads);
+      ga::batch::summarize(summaries, filepaths, options, pool);
+    } else {
+      ga::batch::summarize(summaries, filepaths, options);
+    }
+    if (output != nullptr) {
+      ga::batch::write(summaries, output);
+    } else {
+      ga::batch::write(summaries, stdout);
+    }
+  } catch (const std::exception& exception) {
+    std::fprintf(stderr, "%s\n", exception.what());
+    return EXIT_FAILURE;
+  }
+  for (const ga::batch::Summary& summary : summaries) {
+    if (!summary.Error.empty()) {
+      std::fprintf(stderr, "%s: %s\n", summary.File.c_str(),
+        summary.Error.c_str());
+      failed++;
+    }
+  }
+  return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+void usage() {
+  std::fprintf(stderr,
+    "Usage: analysis-batch [options] <directory or glob>...\n"
+    "\n"
+    "Parse, filter and summarise every run, a directory means all the .csv\n"
+    "files in it and a glob may use * and ? in the file name.\n"
+    "\n"
+    "Options:\n"
+    "  --window <size>      The filter window size, default 60\n"
+    "  --threshold <sd>     The filter standard deviation, default 0.25\n"
+    "  --limit <MiB>        The most MiB of files loaded at once, default 256\n"
+    "  --threads <count>    The number of threads working on the files, the\n"
+    "                       calling thread included, default one per core\n"
+    "  --output <file>      Write the table to file instead of stdout\n");
+}
+
+bool number(const char* text, double& value) {
+  char* end;
+  value = std::strtod(text, &end);
+  return end != text && *end == '\0';
+}
+
+/* A whole number without a sign */
+bool integer(const char* text, size_t& value) {
+  const char* last = text + std::strlen(text);
+  std::from_chars_result result = std::from_chars(text, last, value);
+  return result.ec == std::errc() && result.ptr == last && last != text;
+}
+
+/* Match a file name against a pattern with * and ? */
+bool match(const char* pattern, const char* name) {
+  const char* star = nullptr;
+  const char* resume = nullptr;
+  while (*name != '\0') {
+    if (*pattern == '*') {
+      star = pattern++;
+      resume = name;
+    } else if (*pattern == '?' || *pattern == *name) {
+      pattern++;
+      name++;
+    } else if (star != nullptr) {
+      pattern = star + 1;
+      name = ++resume;
+    } else {
+      return false;
+    }
+  }
+  while (*pattern == '*') {
+    pattern++;
+  }
+  return *pattern == '\0';
+}
+
+void expand(std::vector<std::string>& filepaths, const char* argument) {
+  std::error_code error;
+  fs::path path(argument);
+  std::string pattern("*.csv");
+  if (!fs::is_directory(path, error)) {
+    pattern = path.filename().string();
+    path = path.parent_path();
+    if (path.empty()) {
+      path = ".";
+    }
+  }
+  std::vector<std::string> found;
+  for (const fs::directory_entry& entry :
+    fs::directory_iterator(path, error)) {
+    if (entry.is_regular_file(error) &&
+      match(pattern.c_str(), entry.path().filename().string().c_str())) {
+      found.push_back(entry.path().string());
+    }
+  }
+  if (found.empty()) {
+    std::fprintf(stderr, "No files match '%s'\n", argument);
+  }
+  std::sort(found.begin(), found.end());
+  filepaths.insert(filepaths.end(), found.begin(), found.end());
+}
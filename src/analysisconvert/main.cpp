@@ -0,0 +1,91 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <filesystem>
+#include <string>
+
+#include <gos/analysis/raw.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+static void usage();
+static bool column(const char* text, size_t& index);
+
+int main(int argc, char* argv[]) {
+  ga::tc::raw::Output output = ga::tc::raw::Output::Text;
+  ga::tc::raw::Layout layout;
+  const char* source = nullptr;
+  const char* destination = nullptr;
+  for (int i = 1; i < argc; i++) {
+    const char* argument = argv[i];
+    if (::strcmp(argument, "--binary") == 0) {
+      output = ga::tc::raw::Output::Binary;
+    } else if (::strcmp(argument, "--time") == 0 && i + 1 < argc) {
+      if (!column(argv[++i], layout.Time)) {
+        usage();
+        return EXIT_FAILURE;
+      }
+    } else if (::strcmp(argument, "--control") == 0 && i + 1 < argc) {
+      if (!column(argv[++i], layout.Control)) {
+        usage();
+        return EXIT_FAILURE;
+      }
+    } else if (::strcmp(argument, "--temperature") == 0 && i + 1 < argc) {
+      if (!column(argv[++i], layout.Temperature)) {
+        usage();
+        return EXIT_FAILURE;
+      }
+    } else if (source == nullptr) {
+      source = argument;
+    } else if (destination == nullptr) {
+      destination = argument;
+    } else {
+      usage();
+      return EXIT_FAILURE;
+    }
+  }
+  if (source == nullptr || destination == nullptr) {
+    usage();
+    return EXIT_FAILURE;
+  }
+  try {
+    if (std::filesystem::is_directory(source)) {
+      size_t count = ga::tc::raw::convertdirectory(
+        source, destination, output, layout);
+      std::printf("Converted %zu files\n", count);
+    } else {
+      size_t count = ga::tc::raw::convert(
+        source, destination, output, layout);
+      std::printf("Converted %zu rows\n", count);
+    }
+  } catch (const std::exception& exception) {
+    std::fprintf(stderr, "%s\n", exception.what());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+void usage() {
+  std::fprintf(stderr,
+    "Usage: analysisconvert [options] <raw file> <standard file>\n"
+    "       analysisconvert [options] <raw directory> <standard directory>\n"
+    "\n"
+    "Options:\n"
+    "  --binary             Write the binary format (.tcb) instead of CSV\n"
+    "  --time <column>      The time column in milliseconds, default 0\n"
+    "  --control <column>   The control column, default 2\n"
+    "  --temperature <column>\n"
+    "                       The temperature column, default 3\n");
+}
+
+bool column(const char* text, size_t& index) {
+  char* end;
+  long value = std::strtol(text, &end, 10);
+  if (end == text || *end != '\0' || value < 0) {
+    return false;
+  }
+  index = static_cast<size_t>(value);
+  return true;
+}
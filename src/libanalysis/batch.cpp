@@ -0,0 +1,232 @@
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+
+#include <algorithm>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <numeric>
+#include <system_error>
+
+#include <gos/analysis/batch.h>
+#include <gos/analysis/schema.h>
+#include <gos/analysis/tc.h>
+#include <gos/analysis/window.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+namespace gos {
+namespace analysis {
+namespace batch {
+
+namespace detail {
+struct Time : schema::field<double, schema::Missing::Mask> {
+  static const char* name() { return "time"; }
+};
+struct Temperature : schema::field<double, schema::Missing::NaN> {
+  static const char* name() { return "temperature"; }
+};
+/* The columns every standard file and PID log has */
+typedef schema::table<Time, Temperature> Run;
+/* Bytes of files loaded at the same time */
+class budget {
+public:
+  budget(const ::std::uint64_t& limit);
+  void acquire(const ::std::uint64_t& bytes);
+  void release(const ::std::uint64_t& bytes);
+private:
+  ::std::mutex mutex_;
+  ::std::condition_variable condition_;
+  ::std::uint64_t limit_;
+  ::std::uint64_t used_;
+};
+static void analyse(Summary& summary, const Options& options);
+static void number(::std::FILE* file, const double& value, const char& end);
+} // namespace detail
+
+Options::Options() :
+  WindowSize(60),
+  Threshold(0.25),
+  Limit(::std::uint64_t(256) << 20) {
+}
+
+Summary::Summary() :
+  Bytes(0),
+  Rows(0),
+  Missing(0),
+  Stable(0),
+  Duration(0.0),
+  Mean(0.0),
+  Sd(0.0),
+  Minimum(0.0),
+  Maximum(0.0),
+  StableMean(0.0) {
+}
+
+Summary summarize(const char* filepath, const Options& options) {
+  Summary summary;
+  summary.File = filepath;
+  std::error_code error;
+  summary.Bytes = std::filesystem::file_size(filepath, error);
+  try {
+    detail::analyse(summary, options);
+  } catch (const std::exception& exception) {
+    summary.Error = exception.what();
+  }
+  return summary;
+}
+
+void summarize(
+  SummaryVector& summaries,
+  const std::vector<std::string>& filepaths,
+  const Options& options,
+  ::gos::analysis::pool& pool) {
+  size_t count = filepaths.size();
+  std::vector<std::uint64_t> sizes(count, 0);
+  for (size_t i = 0; i < count; i++) {
+    std::error_code error;
+    sizes[i] = std::filesystem::file_size(filepaths[i], error);
+  }
+  /* Largest first so a large file started last does not hold up the end */
+  std::vector<size_t> order(count);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+    [&sizes](const size_t& a, const size_t& b) {
+      return sizes[a] > sizes[b];
+    });
+  summaries.assign(count, Summary());
+  detail::budget budget(options.Limit);
+  pool.run(count, [&](size_t i) {
+    size_t index = order[i];
+    budget.acquire(sizes[index]);
+    summaries[index] = summarize(filepaths[index].c_str(), options);
+    budget.release(sizes[index]);
+  });
+}
+
+void write(const SummaryVector& summaries, const char* filepath) {
+  std::FILE* file = std::fopen(filepath, "wb");
+  if (file == nullptr) {
+    std::string what("Failed to open '");
+    what += filepath;
+    what += "'";
+    throw ga::exception(what.c_str());
+  }
+  write(summaries, file);
+  bool failed = std::ferror(file) != 0;
+  if (std::fclose(file) != 0 || failed) {
+    throw ga::exception("Failed to write the summary table");
+  }
+}
+
+void write(const SummaryVector& summaries, std::FILE* file) {
+  std::fputs("file,bytes,rows,missing,stable,duration,mean,sd,minimum,"
+    "maximum,stablemean,error\n", file);
+  for (const Summary& summary : summaries) {
+    /* Quoted, the file path and the error may have commas */
+    std::string path(summary.File), error(summary.Error);
+    for (std::string* text : { &path, &error }) {
+      for (size_t at = 0; (at = text->find('"', at)) != std::string::npos;
+        at += 2) {
+        text->insert(at, 1, '"');
+      }
+    }
+    std::fprintf(file, "\"%s\",%llu,%zu,%zu,%zu,", path.c_str(),
+      static_cast<unsigned long long>(summary.Bytes), summary.Rows,
+      summary.Missing, summary.Stable);
+    detail::number(file, summary.Duration, ',');
+    detail::number(file, summary.Mean, ',');
+    detail::number(file, summary.Sd, ',');
+    detail::number(file, summary.Minimum, ',');
+    detail::number(file, summary.Maximum, ',');
+    detail::number(file, summary.StableMean, ',');
+    std::fprintf(file, "\"%s\"\n", error.c_str());
+  }
+}
+
+namespace detail {
+
+budget::budget(const std::uint64_t& limit) : limit_(limit), used_(0) {
+}
+
+/* Wait until the bytes fit in the limit, or nothing else is loaded */
+void budget::acquire(const std::uint64_t& bytes) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this, &bytes]() {
+    return used_ == 0 || used_ + bytes <= limit_;
+  });
+  used_ += bytes;
+}
+
+void budget::release(const std::uint64_t& bytes) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    used_ -= bytes;
+  }
+  condition_.notify_all();
+}
+
+void analyse(Summary& summary, const Options& options) {
+  Run run;
+  run.parse(summary.File.c_str());
+  const std::vector<double>& time = run.column<Time>();
+  const schema::Mask& present = run.mask<Time>();
+  const std::vector<double>& temperature = run.column<Temperature>();
+  summary.Rows = run.size();
+  double first = 0.0, last = 0.0;
+  bool timed = false;
+  for (size_t i = 0; i < run.size(); i++) {
+    if (present[i]) {
+      if (!timed) {
+        first = time[i];
+        timed = true;
+      }
+      last = time[i];
+    }
+  }
+  summary.Duration = last - first;
+  /* The statistics of the whole run from a window holding all of it, the
+     batch add drops the missing temperatures */
+  ga::window all(std::max<size_t>(run.size(), 1));
+  all.add(temperature.data(), temperature.size());
+  summary.Missing = run.size() - all.count();
+  if (all.count() > 0) {
+    summary.Mean = all.mean();
+    summary.Sd = all.sd();
+    summary.Minimum = all.minimum();
+    summary.Maximum = all.maximum();
+  }
+  /* The stable rows are those the tc filter keeps */
+  ga::tc::StandardVector rows, stable;
+  rows.reserve(all.count());
+  for (size_t i = 0; i < run.size(); i++) {
+    if (!std::isnan(temperature[i])) {
+      rows.emplace_back(present[i] ? time[i] : 0.0, 0.0, temperature[i]);
+    }
+  }
+  ga::tc::filter(stable, rows, options.WindowSize, options.Threshold);
+  summary.Stable = stable.size();
+  if (summary.Stable > 0) {
+    double sum = 0.0;
+    for (const ga::tc::Standard& row : stable) {
+      sum += row.Temperature;
+    }
+    summary.StableMean = sum / static_cast<double>(summary.Stable);
+  }
+}
+
+void number(std::FILE* file, const double& value, const char& end) {
+  char buffer[32];
+  std::to_chars_result result =
+    std::to_chars(buffer, buffer + sizeof(buffer) - 1, value);
+  *result.ptr++ = end;
+  std::fwrite(buffer, 1, static_cast<size_t>(result.ptr - buffer), file);
+}
+
+} // namespace detail
+
+} // namespace batch
+} // namespace analysis
+} // namespace gos
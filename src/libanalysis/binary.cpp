@@ -0,0 +1,441 @@
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <thread>
+
+#include <gos/analysis/binary.h>
+#include <gos/analysis/mapping.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+namespace fs = ::std::filesystem;
+
+namespace gos {
+namespace analysis {
+namespace tc {
+namespace binary {
+
+namespace detail {
+struct Header {
+  char Magic[4];
+  ::std::uint32_t Version;
+  ::std::uint32_t Order;
+  ::std::uint32_t Columns;
+  ::std::uint64_t Rows;
+  ::std::uint64_t SourceSize;
+  ::std::uint64_t Checksum;
+  ::std::uint64_t Offsets[3];
+};
+static const char Magic[4] = { 'G', 'T', 'C', 'B' };
+static const ::std::uint64_t Alignment = 64;
+static const size_t BlockSize = 65536;
+static const ::std::uint64_t Prime = 0x100000001b3ULL;
+static ::std::uint64_t align(const ::std::uint64_t& offset);
+static void start(::std::uint64_t* lanes);
+static void mix(
+  ::std::uint64_t* lanes,
+  const double* column,
+  const size_t& count);
+static ::std::uint64_t finish(
+  const ::std::uint64_t* lanes,
+  const ::std::uint64_t& count);
+static ::std::uint64_t checksum(const double* column, const size_t& count);
+static void pad(::std::FILE* file, const ::std::uint64_t& count);
+static void copy(::std::FILE* destination, ::std::FILE* source);
+static bool extract(
+  StandardFrame& frame,
+  const char* tcbpath,
+  const ::std::uint64_t* sourcesize);
+} // namespace detail
+
+std::string path(const char* filepath) {
+  std::string result(filepath);
+  result += ".tcb";
+  return result;
+}
+
+/* The path with the writing process, thread and a counter */
+std::string temporary(const char* filepath) {
+  static std::atomic<std::uint64_t> counter(0);
+#ifdef _WIN32
+  long long process = static_cast<long long>(::_getpid());
+#else
+  long long process = static_cast<long long>(::getpid());
+#endif
+  char suffix[96];
+  std::snprintf(suffix, sizeof(suffix), ".%lld.%zx.%llu.tmp", process,
+    std::hash<std::thread::id>()(std::this_thread::get_id()),
+    static_cast<unsigned long long>(counter++));
+  std::string result(filepath);
+  result += suffix;
+  return result;
+}
+
+void write(
+  const StandardFrame& frame,
+  const char* tcbpath,
+  const ::std::uint64_t& sourcesize) {
+  const StandardFrame::Column* columns[] = {
+    &frame.Time, &frame.Control, &frame.Temperature };
+  detail::Header header;
+  std::memcpy(header.Magic, detail::Magic, sizeof(header.Magic));
+  header.Version = Version;
+  header.Order = 1;
+  header.Columns = 3;
+  header.Rows = frame.size();
+  header.SourceSize = sourcesize;
+  header.Checksum = 0;
+  std::uint64_t offset = detail::align(sizeof(detail::Header));
+  for (int i = 0; i < 3; i++) {
+    header.Offsets[i] = offset;
+    header.Checksum ^= detail::checksum(columns[i]->data(), frame.size()) +
+      static_cast<std::uint64_t>(i);
+    offset = detail::align(offset + frame.size() * sizeof(double));
+  }
+  /* Write to a temporary file and rename it so a reader never sees a
+     partly written cache, the name is unique to the writer */
+  std::string temporary = binary::temporary(tcbpath);
+  {
+    std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+      throw ga::exception("Failed to create the binary cache");
+    }
+    const char padding[detail::Alignment] = { 0 };
+    std::uint64_t position = sizeof(detail::Header);
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int i = 0; i < 3; i++) {
+      stream.write(padding, static_cast<std::streamsize>(
+        header.Offsets[i] - position));
+      stream.write(reinterpret_cast<const char*>(columns[i]->data()),
+        static_cast<std::streamsize>(frame.size() * sizeof(double)));
+      position = header.Offsets[i] + frame.size() * sizeof(double);
+    }
+    if (!stream) {
+      stream.close();
+      std::error_code error;
+      fs::remove(temporary, error);
+      throw ga::exception("Failed to write the binary cache");
+    }
+  }
+  std::error_code error;
+  fs::rename(temporary, tcbpath, error);
+  if (error) {
+    fs::remove(temporary, error);
+    throw ga::exception("Failed to replace the binary cache");
+  }
+}
+
+bool read(StandardFrame& frame, const char* tcbpath) {
+  return detail::extract(frame, tcbpath, nullptr);
+}
+
+bool load(StandardFrame& frame, const char* filepath) {
+  std::string tcbpath = path(filepath);
+  std::error_code error;
+  fs::file_time_type cachetime = fs::last_write_time(tcbpath, error);
+  if (error) {
+    return false;
+  }
+  fs::file_time_type sourcetime = fs::last_write_time(filepath, error);
+  if (error || cachetime < sourcetime) {
+    return false;
+  }
+  std::uint64_t sourcesize = fs::file_size(filepath, error);
+  if (error) {
+    return false;
+  }
+  return detail::extract(frame, tcbpath.c_str(), &sourcesize);
+}
+
+bool save(const StandardFrame& frame, const char* filepath) {
+  std::error_code error;
+  std::uint64_t sourcesize = fs::file_size(filepath, error);
+  if (error) {
+    return false;
+  }
+  try {
+    write(frame, path(filepath).c_str(), sourcesize);
+  } catch (const ga::exception&) {
+    return false;
+  }
+  return true;
+}
+
+writer::writer(const char* tcbpath, const ::std::uint64_t& sourcesize) :
+  tcbpath_(tcbpath),
+  sourcesize_(sourcesize),
+  count_(0),
+  files_{ nullptr, nullptr, nullptr } {
+  for (int i = 0; i < 3; i++) {
+    temporaries_[i] = temporary(tcbpath);
+    files_[i] = std::fopen(temporaries_[i].c_str(), "w+b");
+    if (files_[i] == nullptr) {
+      discard();
+      throw ga::exception("Failed to create the binary cache");
+    }
+    columns_[i].reserve(detail::BlockSize);
+    detail::start(lanes_[i]);
+  }
+  /* The header is written by close once the offsets are known */
+  try {
+    detail::pad(files_[0], detail::align(sizeof(detail::Header)));
+  } catch (const ga::exception&) {
+    discard();
+    throw;
+  }
+}
+
+writer::~writer() {
+  discard();
+}
+
+void writer::add(
+  const double& time,
+  const double& control,
+  const double& temperature) {
+  columns_[0].push_back(time);
+  columns_[1].push_back(control);
+  columns_[2].push_back(temperature);
+  if (columns_[0].size() == detail::BlockSize) {
+    flush();
+  }
+}
+
+void writer::close() {
+  if (files_[0] == nullptr) {
+    throw ga::exception("The binary cache writer is closed");
+  }
+  try {
+    flush();
+    detail::Header header;
+    std::memcpy(header.Magic, detail::Magic, sizeof(header.Magic));
+    header.Version = Version;
+    header.Order = 1;
+    header.Columns = 3;
+    header.Rows = count_;
+    header.SourceSize = sourcesize_;
+    header.Checksum = 0;
+    std::uint64_t bytes = count_ * sizeof(double);
+    header.Offsets[0] = detail::align(sizeof(detail::Header));
+    for (int i = 1; i < 3; i++) {
+      std::uint64_t end = header.Offsets[i - 1] + bytes;
+      header.Offsets[i] = detail::align(end);
+      detail::pad(files_[0], header.Offsets[i] - end);
+      std::rewind(files_[i]);
+      detail::copy(files_[0], files_[i]);
+    }
+    for (int i = 0; i < 3; i++) {
+      header.Checksum ^= detail::finish(lanes_[i], count_) +
+        static_cast<std::uint64_t>(i);
+    }
+    if (std::fseek(files_[0], 0, SEEK_SET) != 0 ||
+      std::fwrite(&header, sizeof(header), 1, files_[0]) != 1) {
+      throw ga::exception("Failed to write the binary cache");
+    }
+    for (int i = 0; i < 3; i++) {
+      int result = std::fclose(files_[i]);
+      files_[i] = nullptr;
+      if (result != 0) {
+        throw ga::exception("Failed to write the binary cache");
+      }
+    }
+  } catch (const ga::exception&) {
+    discard();
+    throw;
+  }
+  std::error_code error;
+  fs::remove(temporaries_[1], error);
+  fs::remove(temporaries_[2], error);
+  fs::rename(temporaries_[0], tcbpath_, error);
+  if (error) {
+    discard();
+    throw ga::exception("Failed to replace the binary cache");
+  }
+  for (int i = 0; i < 3; i++) {
+    temporaries_[i].clear();
+  }
+}
+
+const std::uint64_t& writer::count() const {
+  return count_;
+}
+
+/* Mix and write the buffered rows, every block but the last is a
+   multiple of four rows as the checksum needs */
+void writer::flush() {
+  if (files_[0] == nullptr) {
+    throw ga::exception("The binary cache writer is closed");
+  }
+  size_t rows = columns_[0].size();
+  for (int i = 0; i < 3; i++) {
+    detail::mix(lanes_[i], columns_[i].data(), rows);
+    if (std::fwrite(columns_[i].data(), sizeof(double), rows, files_[i]) !=
+      rows) {
+      throw ga::exception("Failed to write the binary cache");
+    }
+    columns_[i].clear();
+  }
+  count_ += rows;
+}
+
+/* Close and remove the temporary files */
+void writer::discard() {
+  std::error_code error;
+  for (int i = 0; i < 3; i++) {
+    if (files_[i] != nullptr) {
+      std::fclose(files_[i]);
+      files_[i] = nullptr;
+    }
+    if (!temporaries_[i].empty()) {
+      fs::remove(temporaries_[i], error);
+      temporaries_[i].clear();
+    }
+  }
+}
+
+namespace detail {
+
+std::uint64_t align(const std::uint64_t& offset) {
+  return (offset + Alignment - 1) / Alignment * Alignment;
+}
+
+/* Four lanes of a multiply and rotate word hash, fast enough to check
+   the cache at memory bandwidth */
+void start(std::uint64_t* lanes) {
+  lanes[0] = 0xcbf29ce484222325ULL;
+  lanes[1] = 0x84222325cbf29ce4ULL;
+  lanes[2] = 0x9ce484222325cbf2ULL;
+  lanes[3] = 0x2325cbf29ce48422ULL;
+}
+
+/* Words in groups of four go to the four lanes and the rest to the first,
+   so a column can be mixed in parts when all but the last are a multiple
+   of four long */
+void mix(std::uint64_t* lanes, const double* column, const size_t& count) {
+  size_t i = 0;
+  std::uint64_t word;
+  for (; i + 4 <= count; i += 4) {
+    for (size_t lane = 0; lane < 4; lane++) {
+      std::memcpy(&word, column + i + lane, sizeof(word));
+      lanes[lane] = (lanes[lane] ^ word) * Prime;
+      lanes[lane] ^= lanes[lane] >> 29;
+    }
+  }
+  for (; i < count; i++) {
+    std::memcpy(&word, column + i, sizeof(word));
+    lanes[0] = (lanes[0] ^ word) * Prime;
+    lanes[0] ^= lanes[0] >> 29;
+  }
+}
+
+std::uint64_t finish(const std::uint64_t* lanes, const std::uint64_t& count) {
+  std::uint64_t result = count;
+  for (size_t lane = 0; lane < 4; lane++) {
+    result = (result ^ lanes[lane]) * Prime;
+  }
+  return result;
+}
+
+std::uint64_t checksum(const double* column, const size_t& count) {
+  std::uint64_t lanes[4];
+  start(lanes);
+  mix(lanes, column, count);
+  return finish(lanes, count);
+}
+
+void pad(std::FILE* file, const std::uint64_t& count) {
+  const char padding[Alignment] = { 0 };
+  if (count > 0 && std::fwrite(padding, 1, count, file) != count) {
+    throw ga::exception("Failed to write the binary cache");
+  }
+}
+
+/* Append the rest of source to destination */
+void copy(std::FILE* destination, std::FILE* source) {
+  std::vector<char> buffer(BlockSize * sizeof(double));
+  size_t read;
+  while ((read = std::fread(buffer.data(), 1, buffer.size(), source)) > 0) {
+    if (std::fwrite(buffer.data(), 1, read, destination) != read) {
+      throw ga::exception("Failed to write the binary cache");
+    }
+  }
+  if (std::ferror(source)) {
+    throw ga::exception("Failed to read a binary cache column");
+  }
+}
+
+/* Append the columns of the cache when it can be mapped and the header,
+   the size of the source when given and the checksum all match. A cache
+   that cannot be mapped, as one removed since it was found, is a miss. */
+bool extract(
+  StandardFrame& frame,
+  const char* tcbpath,
+  const std::uint64_t* sourcesize) {
+  std::unique_ptr<ga::mapping> mapped;
+  try {
+    mapped = std::make_unique<ga::mapping>(tcbpath);
+  } catch (const std::exception&) {
+    return false;
+  }
+  const ga::mapping& mapping = *mapped;
+  if (mapping.size() < sizeof(detail::Header)) {
+    return false;
+  }
+  detail::Header header;
+  std::memcpy(&header, mapping.data(), sizeof(header));
+  if (std::memcmp(header.Magic, detail::Magic, sizeof(header.Magic)) != 0 ||
+    header.Version != Version ||
+    header.Order != 1 ||
+    header.Columns != 3 ||
+    (sourcesize != nullptr && header.SourceSize != *sourcesize)) {
+    return false;
+  }
+  if (header.Rows > mapping.size() / sizeof(double)) {
+    return false;
+  }
+  std::uint64_t bytes = header.Rows * sizeof(double);
+  for (int i = 0; i < 3; i++) {
+    if (header.Offsets[i] % sizeof(double) != 0 ||
+      header.Offsets[i] > mapping.size() ||
+      bytes > mapping.size() - header.Offsets[i]) {
+      return false;
+    }
+  }
+  size_t rows = static_cast<size_t>(header.Rows);
+  std::uint64_t checksum = 0;
+  for (int i = 0; i < 3; i++) {
+    const double* column = reinterpret_cast<const double*>(
+      mapping.data() + header.Offsets[i]);
+    checksum ^= detail::checksum(column, rows) + static_cast<std::uint64_t>(i);
+  }
+  if (checksum != header.Checksum) {
+    return false;
+  }
+  StandardFrame::Column* columns[] = {
+    &frame.Time, &frame.Control, &frame.Temperature };
+  for (int i = 0; i < 3; i++) {
+    const double* column = reinterpret_cast<const double*>(
+      mapping.data() + header.Offsets[i]);
+    columns[i]->insert(columns[i]->end(), column, column + rows);
+  }
+  return true;
+}
+
+} // namespace detail
+
+} // namespace binary
+} // namespace tc
+} // namespace analysis
+} // namespace gos
@@ -0,0 +1,185 @@
+#include <cmath>
+
+#include <algorithm>
+
+#include <gos/analysis/bivariate.h>
+
+namespace ga = ::gos::analysis;
+
+namespace gos {
+namespace analysis {
+
+bivariate::bivariate() :
+  size_(10),
+  head_(0),
+  count_(0),
+  meanx_(0.0),
+  meany_(0.0),
+  m2x_(0.0),
+  m2y_(0.0),
+  cxy_(0.0),
+  replacements_(0) {
+}
+
+bivariate::bivariate(const size_t& size) :
+  size_(size),
+  head_(0),
+  count_(0),
+  meanx_(0.0),
+  meany_(0.0),
+  m2x_(0.0),
+  m2y_(0.0),
+  cxy_(0.0),
+  replacements_(0) {
+}
+
+void bivariate::add(const double& x, const double& y) {
+  if (this->size_ == 0) {
+    return;
+  }
+  if (this->x_.size() != this->size_) {
+    this->x_.resize(this->size_);
+    this->y_.resize(this->size_);
+  }
+  double dx, dy;
+  if (this->count_ < this->size_) {
+    size_t position = this->head_ + this->count_;
+    if (position >= this->size_) {
+      position -= this->size_;
+    }
+    this->x_[position] = x;
+    this->y_[position] = y;
+    this->count_++;
+    double n = static_cast<double>(this->count_);
+    dx = x - this->meanx_;
+    dy = y - this->meany_;
+    this->meanx_ += dx / n;
+    this->meany_ += dy / n;
+    this->m2x_ += dx * (x - this->meanx_);
+    this->m2y_ += dy * (y - this->meany_);
+    this->cxy_ += dx * (y - this->meany_);
+  } else {
+    double ex = this->x_[this->head_];
+    double ey = this->y_[this->head_];
+    this->x_[this->head_] = x;
+    this->y_[this->head_] = y;
+    if (++(this->head_) >= this->size_) {
+      this->head_ = 0;
+    }
+    if (this->count_ == 1) {
+      this->synchronize();
+      return;
+    }
+    /* Remove the evicted pair and add the new one */
+    double n = static_cast<double>(this->count_);
+    double meanx = this->meanx_ - (ex - this->meanx_) / (n - 1.0);
+    double meany = this->meany_ - (ey - this->meany_) / (n - 1.0);
+    this->m2x_ -= (ex - meanx) * (ex - this->meanx_);
+    this->m2y_ -= (ey - meany) * (ey - this->meany_);
+    this->cxy_ -= (ex - meanx) * (ey - this->meany_);
+    dx = x - meanx;
+    dy = y - meany;
+    this->meanx_ = meanx + dx / n;
+    this->meany_ = meany + dy / n;
+    this->m2x_ += dx * (x - this->meanx_);
+    this->m2y_ += dy * (y - this->meany_);
+    this->cxy_ += dx * (y - this->meany_);
+    /* Resynchronise once per window length to bound the rounding drift */
+    if (++(this->replacements_) >= this->size_) {
+      this->synchronize();
+    }
+  }
+}
+
+void bivariate::set(const size_t& size) {
+  if (size != this->size_) {
+    size_t count = std::min(this->count_, size);
+    ga::type::DoubleVector x(size), y(size);
+    for (size_t i = 0; i < count; i++) {
+      size_t position = (this->head_ + this->count_ - count + i) % this->size_;
+      x[i] = this->x_[position];
+      y[i] = this->y_[position];
+    }
+    this->x_.swap(x);
+    this->y_.swap(y);
+    this->head_ = 0;
+    this->count_ = count;
+    this->size_ = size;
+    this->synchronize();
+  }
+}
+
+const size_t& bivariate::size() const {
+  return size_;
+}
+
+size_t bivariate::count() const {
+  return count_;
+}
+
+void bivariate::clear() {
+  this->head_ = 0;
+  this->count_ = 0;
+  this->meanx_ = 0.0;
+  this->meany_ = 0.0;
+  this->m2x_ = 0.0;
+  this->m2y_ = 0.0;
+  this->cxy_ = 0.0;
+  this->replacements_ = 0;
+}
+
+const double& bivariate::meanx() const {
+  return meanx_;
+}
+
+const double& bivariate::meany() const {
+  return meany_;
+}
+
+double bivariate::variancex() const {
+  return std::max(m2x_, 0.0) / static_cast<double>(count_);
+}
+
+double bivariate::variancey() const {
+  return std::max(m2y_, 0.0) / static_cast<double>(count_);
+}
+
+double bivariate::covariance() const {
+  return cxy_ / static_cast<double>(count_);
+}
+
+double bivariate::correlation() const {
+  double denominator = ::sqrt(std::max(m2x_, 0.0) * std::max(m2y_, 0.0));
+  if (denominator > 0.0) {
+    return std::min(std::max(cxy_ / denominator, -1.0), 1.0);
+  } else {
+    return 0.0;
+  }
+}
+
+void bivariate::synchronize() {
+  double sumx = 0.0, sumy = 0.0;
+  /* The pairs occupy the start of the buffers, order does not matter */
+  for (size_t i = 0; i < this->count_; i++) {
+    sumx += this->x_[i];
+    sumy += this->y_[i];
+  }
+  double n = static_cast<double>(this->count_);
+  this->meanx_ = this->count_ > 0 ? sumx / n : 0.0;
+  this->meany_ = this->count_ > 0 ? sumy / n : 0.0;
+  double m2x = 0.0, m2y = 0.0, cxy = 0.0;
+  for (size_t i = 0; i < this->count_; i++) {
+    double dx = this->x_[i] - this->meanx_;
+    double dy = this->y_[i] - this->meany_;
+    m2x += dx * dx;
+    m2y += dy * dy;
+    cxy += dx * dy;
+  }
+  this->m2x_ = m2x;
+  this->m2y_ = m2y;
+  this->cxy_ = cxy;
+  this->replacements_ = 0;
+}
+
+} // namespace analysis
+} // namespace gos
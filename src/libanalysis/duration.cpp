@@ -0,0 +1,152 @@
+#include <cmath>
+
+#include <algorithm>
+
+#include <gos/analysis/duration.h>
+#include <gos/analysis/exception.h>
+
+namespace gos {
+namespace analysis {
+
+duration::duration() :
+  span_(60.0),
+  head_(0),
+  count_(0),
+  mean_(0.0),
+  m2_(0.0),
+  removals_(0) {
+}
+
+duration::duration(const double& span) :
+  span_(span),
+  head_(0),
+  count_(0),
+  mean_(0.0),
+  m2_(0.0),
+  removals_(0) {
+}
+
+void duration::add(const double& value, const double& time) {
+  if (std::isnan(time) ||
+    (this->count_ > 0 && time < this->item(this->count_ - 1).Time)) {
+    throw ::gos::analysis::exception(
+      "The duration window times must be in ascending order");
+  }
+  this->evict(time);
+  if (this->count_ == this->items_.size()) {
+    this->grow();
+  }
+  size_t position = this->head_ + this->count_;
+  if (position >= this->items_.size()) {
+    position -= this->items_.size();
+  }
+  this->items_[position] = Item{ time, value };
+  this->count_++;
+  double delta = value - this->mean_;
+  this->mean_ += delta / static_cast<double>(this->count_);
+  this->m2_ += delta * (value - this->mean_);
+}
+
+void duration::set(const double& span) {
+  this->span_ = span;
+  if (this->count_ > 0) {
+    this->evict(this->item(this->count_ - 1).Time);
+  }
+}
+
+const double& duration::span() const {
+  return span_;
+}
+
+size_t duration::count() const {
+  return count_;
+}
+
+void duration::clear() {
+  this->head_ = 0;
+  this->count_ = 0;
+  this->mean_ = 0.0;
+  this->m2_ = 0.0;
+  this->removals_ = 0;
+}
+
+const double& duration::at(const size_t& index) const {
+  return item(index).Value;
+}
+
+double duration::sum() const {
+  return mean_ * static_cast<double>(count_);
+}
+
+const double& duration::mean() const {
+  return mean_;
+}
+
+double duration::variance() const {
+  return std::max(m2_, 0.0) / static_cast<double>(count_);
+}
+
+double duration::sd() const {
+  return ::sqrt(variance());
+}
+
+void duration::evict(const double& time) {
+  double oldest = time - this->span_;
+  while (this->count_ > 0 && this->items_[this->head_].Time <= oldest) {
+    double value = this->items_[this->head_].Value;
+    if (++(this->head_) >= this->items_.size()) {
+      this->head_ = 0;
+    }
+    if (--(this->count_) > 0) {
+      double mean = this->mean_ - (value - this->mean_) /
+        static_cast<double>(this->count_);
+      this->m2_ -= (value - mean) * (value - this->mean_);
+      this->mean_ = mean;
+    } else {
+      this->mean_ = 0.0;
+      this->m2_ = 0.0;
+    }
+    this->removals_++;
+  }
+  /* Resynchronise once the removals reach the count to bound the rounding
+     drift at an amortised constant cost */
+  if (this->removals_ > 0 && this->removals_ >= this->count_) {
+    this->synchronize();
+  }
+}
+
+void duration::grow() {
+  ItemVector items(std::max(this->items_.size() * 2, static_cast<size_t>(16)));
+  for (size_t i = 0; i < this->count_; i++) {
+    items[i] = this->item(i);
+  }
+  this->items_.swap(items);
+  this->head_ = 0;
+}
+
+void duration::synchronize() {
+  double sum = 0.0;
+  for (size_t i = 0; i < this->count_; i++) {
+    sum += this->item(i).Value;
+  }
+  double mean = this->count_ > 0 ? sum / this->count_ : 0.0;
+  double m2 = 0.0;
+  for (size_t i = 0; i < this->count_; i++) {
+    double diff = this->item(i).Value - mean;
+    m2 += diff * diff;
+  }
+  this->mean_ = mean;
+  this->m2_ = m2;
+  this->removals_ = 0;
+}
+
+const duration::Item& duration::item(const size_t& index) const {
+  size_t position = head_ + index;
+  if (position >= items_.size()) {
+    position -= items_.size();
+  }
+  return items_[position];
+}
+
+} // namespace analysis
+} // namespace gos
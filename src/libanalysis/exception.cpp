@@ -12,7 +12,7 @@ exception::exception(const char* what) {
 #if _MSC_VER >= 1910
 const char* exception::what() const noexcept { return what_.c_str(); }
 #else
-const char* exception::what() const { return what_.c_str(); }
+const char* exception::what() const noexcept { return what_.c_str(); }
 #endif
 } // namespace analysis
 } // namespace gos
@@ -0,0 +1,108 @@
+#include <cmath>
+
+#include <gos/analysis/exponential.h>
+#include <gos/analysis/exception.h>
+
+namespace gos {
+namespace analysis {
+
+exponential::exponential() :
+  mean_(0.0),
+  variance_(0.0),
+  time_(0.0),
+  count_(0) {
+  sethalflife(10.0);
+}
+
+exponential::exponential(const double& alpha) :
+  mean_(0.0),
+  variance_(0.0),
+  time_(0.0),
+  count_(0) {
+  setalpha(alpha);
+}
+
+void exponential::setalpha(const double& alpha) {
+  if (!(alpha > 0.0 && alpha < 1.0)) {
+    throw ::gos::analysis::exception("The alpha must be between 0 and 1");
+  }
+  alpha_ = alpha;
+  rate_ = -::log1p(-alpha);
+}
+
+void exponential::sethalflife(const double& halflife) {
+  if (!(halflife > 0.0)) {
+    throw ::gos::analysis::exception("The half-life must be positive");
+  }
+  rate_ = ::log(2.0) / halflife;
+  alpha_ = -::expm1(-rate_);
+}
+
+const double& exponential::alpha() const {
+  return alpha_;
+}
+
+double exponential::halflife() const {
+  return ::log(2.0) / rate_;
+}
+
+bool exponential::add(const double& value) {
+  if (std::isnan(value)) {
+    return false;
+  }
+  update(value, alpha_);
+  return true;
+}
+
+bool exponential::add(const double& value, const double& time) {
+  if (std::isnan(value) || std::isnan(time)) {
+    return false;
+  }
+  if (count_ > 0) {
+    double elapsed = time - time_;
+    update(value, elapsed > 0.0 ? -::expm1(-rate_ * elapsed) : 0.0);
+  } else {
+    update(value, alpha_);
+  }
+  time_ = time;
+  return true;
+}
+
+size_t exponential::count() const {
+  return count_;
+}
+
+void exponential::clear() {
+  mean_ = 0.0;
+  variance_ = 0.0;
+  time_ = 0.0;
+  count_ = 0;
+}
+
+const double& exponential::mean() const {
+  return mean_;
+}
+
+const double& exponential::variance() const {
+  return variance_;
+}
+
+double exponential::sd() const {
+  return ::sqrt(variance_);
+}
+
+void exponential::update(const double& value, const double& alpha) {
+  if (count_ == 0) {
+    mean_ = value;
+    variance_ = 0.0;
+  } else {
+    double diff = value - mean_;
+    double increment = alpha * diff;
+    mean_ += increment;
+    variance_ = (1.0 - alpha) * (variance_ + diff * increment);
+  }
+  count_++;
+}
+
+} // namespace analysis
+} // namespace gos
@@ -0,0 +1,420 @@
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+
+#include <gos/analysis/fopdt.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+namespace gos {
+namespace analysis {
+namespace fopdt {
+
+namespace detail {
+/* The rows of a response relative to the step */
+struct Response {
+  ::std::vector<double> Time;
+  ::std::vector<double> Temperature;
+  double Offset;
+  double Change;
+};
+static void response(
+  Response& response,
+  const ga::tc::StandardVector& vector,
+  const Step& step,
+  const Options& options);
+static void estimate(double* parameters, const Response& response);
+static double evaluate(
+  const double* parameters,
+  const Response& response,
+  double* jtj,
+  double* jtr);
+static bool solve(double* x, const double* a, const double* b);
+} // namespace detail
+
+Options::Options() :
+  Threshold(5.0),
+  Merge(10.0),
+  Minimum(60.0),
+  Baseline(10.0),
+  Iterations(100),
+  Tolerance(1e-10),
+  Lambda(0.0) {
+}
+
+Step::Step() :
+  Begin(0),
+  End(0),
+  Time(0.0),
+  Before(0.0),
+  After(0.0) {
+}
+
+Model::Model() :
+  Gain(0.0),
+  TimeConstant(0.0),
+  DeadTime(0.0),
+  Offset(0.0),
+  Error(0.0),
+  Iterations(0) {
+}
+
+Settings::Settings() :
+  Kp(0.0),
+  Ki(0.0),
+  Kd(0.0) {
+}
+
+Identification::Identification() {
+}
+
+void detect(
+  StepVector& steps,
+  const ga::tc::StandardVector& vector,
+  const Options& options) {
+  steps.clear();
+  const size_t count = vector.size();
+  size_t i = 1;
+  while (i < count) {
+    if (!(vector[i].Control != vector[i - 1].Control)) {
+      i++;
+      continue;
+    }
+    /* Follow the changes until the control holds for Merge seconds */
+    size_t last = i;
+    for (size_t j = i + 1; j < count &&
+      vector[j].Time - vector[last].Time <= options.Merge; j++) {
+      if (vector[j].Control != vector[j - 1].Control) {
+        last = j;
+      }
+    }
+    Step step;
+    step.Begin = i;
+    step.Time = vector[i].Time;
+    step.Before = vector[i - 1].Control;
+    step.After = vector[last].Control;
+    if (std::fabs(step.After - step.Before) >= options.Threshold) {
+      if (!steps.empty()) {
+        steps.back().End = step.Begin;
+      }
+      steps.push_back(step);
+    }
+    i = last + 1;
+  }
+  if (!steps.empty()) {
+    steps.back().End = count;
+  }
+  steps.erase(std::remove_if(steps.begin(), steps.end(),
+    [&vector, &options](const Step& step) {
+      return vector[step.End - 1].Time - step.Time < options.Minimum;
+    }), steps.end());
+}
+
+Model fit(
+  const ga::tc::StandardVector& vector,
+  const Step& step,
+  const Options& options) {
+  detail::Response response;
+  detail::response(response, vector, step, options);
+  const double span = response.Time.back();
+  double parameters[3], candidate[3], jtj[9], jtr[3], damped[9], delta[3];
+  detail::estimate(parameters, response);
+  Model model;
+  double cost = detail::evaluate(parameters, response, jtj, jtr);
+  double lambda = 1e-3;
+  while (model.Iterations < options.Iterations && lambda < 1e10) {
+    model.Iterations++;
+    std::copy(jtj, jtj + 9, damped);
+    for (size_t k = 0; k < 3; k++) {
+      damped[k * 4] += lambda * (jtj[k * 4] > 0.0 ? jtj[k * 4] : 1.0);
+    }
+    bool accepted = false;
+    if (detail::solve(delta, damped, jtr)) {
+      for (size_t k = 0; k < 3; k++) {
+        candidate[k] = parameters[k] + delta[k];
+      }
+      /* A positive time constant and a dead time within the response */
+      candidate[1] = std::max(candidate[1], span * 1e-9);
+      candidate[2] = std::min(std::max(candidate[2], 0.0), span);
+      double next = detail::evaluate(candidate, response, nullptr, nullptr);
+      if (next < cost) {
+        accepted = true;
+        double change = (cost - next) / cost;
+        std::copy(candidate, candidate + 3, parameters);
+        cost = detail::evaluate(parameters, response, jtj, jtr);
+        lambda *= 0.1;
+        if (!(change > options.Tolerance)) {
+          break;
+        }
+      }
+    }
+    if (!accepted) {
+      lambda *= 10.0;
+    }
+  }
+  model.Gain = parameters[0];
+  model.TimeConstant = parameters[1];
+  model.DeadTime = parameters[2];
+  model.Offset = response.Offset;
+  model.Error = std::sqrt(cost / static_cast<double>(response.Time.size()));
+  return model;
+}
+
+Settings tune(const Model& model, const Rule& rule, const double& lambda) {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double k = model.Gain;
+  const double tau = model.TimeConstant;
+  const double theta = model.DeadTime;
+  double kp = nan, ti = nan, td = nan;
+  if (k != 0.0 && tau > 0.0) {
+    switch (rule) {
+    case Rule::ZieglerNichols:
+      if (theta > 0.0) {
+        kp = 1.2 * tau / (k * theta);
+        ti = 2.0 * theta;
+        td = 0.5 * theta;
+      }
+      break;
+    case Rule::CohenCoon:
+      if (theta > 0.0) {
+        double r = theta / tau;
+        kp = tau / (k * theta) * (4.0 / 3.0 + r / 4.0);
+        ti = theta * (32.0 + 6.0 * r) / (13.0 + 8.0 * r);
+        td = 4.0 * theta / (11.0 + 2.0 * r);
+      }
+      break;
+    case Rule::Imc: {
+      double l = lambda > 0.0 ? lambda : std::max(0.1 * tau, 0.8 * theta);
+      kp = (2.0 * tau + theta) / (k * (2.0 * l + theta));
+      ti = tau + theta / 2.0;
+      td = tau * theta / (2.0 * tau + theta);
+      break;
+    }
+    }
+  }
+  Settings settings;
+  settings.Kp = kp;
+  settings.Ki = kp / ti;
+  settings.Kd = kp * td;
+  return settings;
+}
+
+void identify(
+  IdentificationVector& identifications,
+  const ga::tc::StandardVector& vector,
+  const Options& options) {
+  identifications.clear();
+  StepVector steps;
+  detect(steps, vector, options);
+  for (const Step& step : steps) {
+    Identification identification;
+    identification.Change = step;
+    try {
+      identification.Fit = fit(vector, step, options);
+      identification.ZieglerNichols = tune(
+        identification.Fit, Rule::ZieglerNichols, options.Lambda);
+      identification.CohenCoon = tune(
+        identification.Fit, Rule::CohenCoon, options.Lambda);
+      identification.Imc = tune(
+        identification.Fit, Rule::Imc, options.Lambda);
+    } catch (const std::exception& exception) {
+      identification.Error = exception.what();
+    }
+    identifications.push_back(identification);
+  }
+}
+
+void identify(
+  IdentificationVector& identifications,
+  const std::vector<std::string>& filepaths,
+  const Options& options,
+  ga::pool& pool) {
+  std::vector<IdentificationVector> files(filepaths.size());
+  pool.run(filepaths.size(), [&](size_t i) {
+    IdentificationVector& file = files[i];
+    try {
+      ga::tc::StandardVector vector;
+      ga::tc::parse(vector, filepaths[i].c_str(), ga::tc::Parser::Mapped);
+      identify(file, vector, options);
+    } catch (const std::exception& exception) {
+      file.assign(1, Identification());
+      file[0].Error = exception.what();
+    }
+    for (Identification& identification : file) {
+      identification.File = filepaths[i];
+    }
+  });
+  identifications.clear();
+  for (IdentificationVector& file : files) {
+    identifications.insert(identifications.end(), file.begin(), file.end());
+  }
+}
+
+namespace detail {
+
+void response(
+  Response& response,
+  const ga::tc::StandardVector& vector,
+  const Step& step,
+  const Options& options) {
+  if (step.End > vector.size() || step.Begin == 0 ||
+    step.Begin >= step.End) {
+    throw ga::exception("The step is not within the run");
+  }
+  response.Change = step.After - step.Before;
+  if (response.Change == 0.0) {
+    throw ga::exception("The step does not change the control");
+  }
+  /* The temperature at the step from the rows just before it */
+  double sum = 0.0;
+  size_t count = 0;
+  for (size_t i = step.Begin; i-- > 0 &&
+    step.Time - vector[i].Time <= options.Baseline;) {
+    if (!std::isnan(vector[i].Temperature)) {
+      sum += vector[i].Temperature;
+      count++;
+    }
+  }
+  if (count == 0) {
+    sum = vector[step.Begin - 1].Temperature;
+    count = 1;
+  }
+  response.Offset = sum / static_cast<double>(count);
+  response.Time.clear();
+  response.Temperature.clear();
+  for (size_t i = step.Begin; i < step.End; i++) {
+    if (!std::isnan(vector[i].Temperature)) {
+      response.Time.push_back(vector[i].Time - step.Time);
+      response.Temperature.push_back(vector[i].Temperature);
+    }
+  }
+  if (response.Time.size() < 4 || std::isnan(response.Offset) ||
+    !(response.Time.back() > 0.0)) {
+    throw ga::exception("Too few rows to fit the step");
+  }
+}
+
+/* The two point method, the time constant is 1.5 (t63 - t28) and the
+   dead time t63 - tau */
+void estimate(double* parameters, const Response& response) {
+  const size_t count = response.Time.size();
+  const size_t tail = std::max<size_t>(1, count / 20);
+  double final = 0.0;
+  for (size_t i = count - tail; i < count; i++) {
+    final += response.Temperature[i];
+  }
+  final /= static_cast<double>(tail);
+  double rise = final - response.Offset;
+  if (!(std::fabs(rise) > 0.0) || !std::isfinite(rise)) {
+    throw ga::exception("The temperature does not respond to the step");
+  }
+  double t28 = -1.0, t63 = -1.0;
+  for (size_t i = 0; i < count && t63 < 0.0; i++) {
+    double fraction = (response.Temperature[i] - response.Offset) / rise;
+    if (t28 < 0.0 && fraction >= 0.283) {
+      t28 = response.Time[i];
+    }
+    if (fraction >= 0.632) {
+      t63 = response.Time[i];
+    }
+  }
+  const double span = response.Time.back();
+  double tau = 1.5 * (t63 - t28);
+  if (!(tau > 0.0)) {
+    tau = std::max(t63, span / 10.0);
+  }
+  parameters[0] = rise / response.Change;
+  parameters[1] = tau;
+  parameters[2] = std::min(std::max(t63 - tau, 0.0), span);
+}
+
+/* The squared error, with the normal equations J'J and J'r of the
+   residuals r when jtj is not null */
+double evaluate(
+  const double* parameters,
+  const Response& response,
+  double* jtj,
+  double* jtr) {
+  const double gain = parameters[0] * response.Change;
+  const double tau = parameters[1];
+  const double theta = parameters[2];
+  const double inverse = 1.0 / tau;
+  const size_t count = response.Time.size();
+  const double* time = response.Time.data();
+  const double* temperature = response.Temperature.data();
+  double cost = 0.0;
+  double a[9] = { 0.0 }, b[3] = { 0.0 };
+  for (size_t i = 0; i < count; i++) {
+    double s = time[i] - theta;
+    double e = s > 0.0 ? std::exp(-s * inverse) : 1.0;
+    double r = temperature[i] - response.Offset - gain * (1.0 - e);
+    cost += r * r;
+    if (jtj != nullptr && s > 0.0) {
+      double j[3] = {
+        response.Change * (1.0 - e),
+        -gain * e * s * inverse * inverse,
+        -gain * e * inverse };
+      for (size_t row = 0; row < 3; row++) {
+        b[row] += j[row] * r;
+        for (size_t column = row; column < 3; column++) {
+          a[row * 3 + column] += j[row] * j[column];
+        }
+      }
+    }
+  }
+  if (jtj != nullptr) {
+    for (size_t row = 0; row < 3; row++) {
+      jtr[row] = b[row];
+      for (size_t column = 0; column < 3; column++) {
+        jtj[row * 3 + column] = column >= row ?
+          a[row * 3 + column] : a[column * 3 + row];
+      }
+    }
+  }
+  return cost;
+}
+
+/* Gaussian elimination with partial pivoting of the 3 x 3 system */
+bool solve(double* x, const double* a, const double* b) {
+  double m[3][4];
+  for (size_t row = 0; row < 3; row++) {
+    for (size_t column = 0; column < 3; column++) {
+      m[row][column] = a[row * 3 + column];
+    }
+    m[row][3] = b[row];
+  }
+  for (size_t k = 0; k < 3; k++) {
+    size_t pivot = k;
+    for (size_t row = k + 1; row < 3; row++) {
+      if (std::fabs(m[row][k]) > std::fabs(m[pivot][k])) {
+        pivot = row;
+      }
+    }
+    if (!(std::fabs(m[pivot][k]) > 0.0)) {
+      return false;
+    }
+    std::swap(m[k], m[pivot]);
+    for (size_t row = k + 1; row < 3; row++) {
+      double factor = m[row][k] / m[k][k];
+      for (size_t column = k; column < 4; column++) {
+        m[row][column] -= factor * m[k][column];
+      }
+    }
+  }
+  for (size_t k = 3; k-- > 0;) {
+    double sum = m[k][3];
+    for (size_t column = k + 1; column < 3; column++) {
+      sum -= m[k][column] * x[column];
+    }
+    x[k] = sum / m[k][k];
+  }
+  return std::isfinite(x[0]) && std::isfinite(x[1]) && std::isfinite(x[2]);
+}
+
+} // namespace detail
+
+} // namespace fopdt
+} // namespace analysis
+} // namespace gos
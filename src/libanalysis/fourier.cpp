@@ -0,0 +1,432 @@
+#include <cmath>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <gos/analysis/fourier.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+namespace gos {
+namespace analysis {
+namespace fourier {
+
+namespace detail {
+/* What the segments of a Welch average or spectrogram share */
+struct Context {
+  const Options* Settings;
+  const realplan* Plan;
+  ga::type::DoubleVector Window;
+  double Scale;
+  size_t Bins;
+  size_t Hop;
+  size_t Segments;
+};
+static void prepare(Context& context, const size_t& count,
+  const Options& options);
+static void density(
+  double* power,
+  const double* values,
+  const Context& context,
+  ga::type::DoubleVector& segment,
+  ComplexVector& coefficients);
+static void partition(
+  const Context& context,
+  ga::pool& pool,
+  const ::std::function<void(size_t, size_t)>& function);
+static Complex multiply(const Complex& a, const Complex& b);
+static ComplexVector& scratch();
+static const double Pi = 3.14159265358979323846;
+/* Partitions of the segments, independent of the threads so the sums
+   are the same on any pool */
+static const size_t Partitions = 64;
+} // namespace detail
+
+plan::plan(const size_t& size) : size_(size) {
+  if (size == 0) {
+    throw ga::exception("The FFT size must be positive");
+  }
+  roots_.resize(size);
+  for (size_t k = 0; k < size; k++) {
+    double angle = -2.0 * detail::Pi * static_cast<double>(k) /
+      static_cast<double>(size);
+    roots_[k] = Complex(std::cos(angle), std::sin(angle));
+  }
+  std::vector<size_t> factors;
+  size_t remaining = size;
+  for (size_t radix : { 4, 2, 3, 5 }) {
+    while (remaining % radix == 0) {
+      factors.push_back(radix);
+      remaining /= radix;
+    }
+  }
+  for (size_t radix = 7; remaining > 1; radix += 2) {
+    while (remaining % radix == 0) {
+      factors.push_back(radix);
+      remaining /= radix;
+    }
+  }
+  size_t span = 1;
+  for (size_t radix : factors) {
+    Stage stage = { radix, span, twiddles_.size() };
+    size_t step = size / (span * radix);
+    for (size_t j = 0; j < span; j++) {
+      for (size_t r = 1; r < radix; r++) {
+        twiddles_.push_back(roots_[j * r * step]);
+      }
+    }
+    stages_.push_back(stage);
+    span *= radix;
+  }
+}
+
+size_t plan::size() const {
+  return size_;
+}
+
+void plan::transform(Complex* data, const bool& inverse) const {
+  if (inverse) {
+    for (size_t i = 0; i < size_; i++) {
+      data[i] = std::conj(data[i]);
+    }
+  }
+  ComplexVector& buffer = detail::scratch();
+  buffer.resize(size_);
+  Complex* source = data;
+  Complex* destination = buffer.data();
+  for (const Stage& stage : stages_) {
+    this->stage(destination, source, stage);
+    std::swap(source, destination);
+  }
+  if (source != data) {
+    std::copy(source, source + size_, data);
+  }
+  if (inverse) {
+    for (size_t i = 0; i < size_; i++) {
+      data[i] = std::conj(data[i]);
+    }
+  }
+}
+
+const plan& plan::cached(const size_t& size) {
+  static std::mutex mutex;
+  static std::map<size_t, std::unique_ptr<plan>> plans;
+  std::unique_lock<std::mutex> lock(mutex);
+  std::unique_ptr<plan>& found = plans[size];
+  if (!found) {
+    found.reset(new plan(size));
+  }
+  return *found;
+}
+
+/* One Stockham stage, the input is read with a stride of size / radix and
+   the output is written in order so no bit reversal is needed */
+void plan::stage(
+  Complex* destination,
+  const Complex* source,
+  const Stage& stage) const {
+  const size_t radix = stage.Radix;
+  const size_t span = stage.Span;
+  const size_t stride = size_ / radix;
+  const size_t blocks = stride / span;
+  const Complex* twiddles = twiddles_.data() + stage.Twiddles;
+  Complex v[5];
+  ComplexVector generic(radix > 5 ? 2 * radix : 0);
+  Complex* in = radix > 5 ? generic.data() : v;
+  for (size_t b = 0; b < blocks; b++) {
+    for (size_t j = 0; j < span; j++) {
+      const Complex* from = source + b * span + j;
+      Complex* to = destination + b * span * radix + j;
+      const Complex* w = twiddles + j * (radix - 1);
+      in[0] = from[0];
+      for (size_t r = 1; r < radix; r++) {
+        in[r] = detail::multiply(from[r * stride], w[r - 1]);
+      }
+      if (radix == 4) {
+        Complex t0 = in[0] + in[2], t1 = in[0] - in[2];
+        Complex t2 = in[1] + in[3], d = in[1] - in[3];
+        Complex t3(d.imag(), -d.real());
+        to[0] = t0 + t2;
+        to[span] = t1 + t3;
+        to[2 * span] = t0 - t2;
+        to[3 * span] = t1 - t3;
+      } else if (radix == 2) {
+        to[0] = in[0] + in[1];
+        to[span] = in[0] - in[1];
+      } else {
+        const size_t step = size_ / radix;
+        for (size_t q = 0; q < radix; q++) {
+          Complex sum = in[0];
+          for (size_t r = 1, at = q; r < radix; r++, at += q) {
+            sum += detail::multiply(in[r], roots_[(at % radix) * step]);
+          }
+          to[q * span] = sum;
+        }
+      }
+    }
+  }
+}
+
+realplan::realplan(const size_t& size) :
+  size_(size),
+  complex_(plan::cached(size % 2 == 0 && size > 0 ? size / 2 : size)) {
+  twiddles_.resize(size / 2 + 1);
+  for (size_t k = 0; k < twiddles_.size(); k++) {
+    double angle = -2.0 * detail::Pi * static_cast<double>(k) /
+      static_cast<double>(size);
+    twiddles_[k] = Complex(std::cos(angle), std::sin(angle));
+  }
+}
+
+size_t realplan::size() const {
+  return size_;
+}
+
+void realplan::forward(Complex* destination, const double* source) const {
+  static thread_local ComplexVector buffer;
+  const size_t n = size_;
+  if (n % 2 != 0) {
+    buffer.resize(n);
+    for (size_t i = 0; i < n; i++) {
+      buffer[i] = Complex(source[i], 0.0);
+    }
+    complex_.transform(buffer.data());
+    std::copy(buffer.begin(), buffer.begin() + (n / 2 + 1), destination);
+    return;
+  }
+  /* The even and odd values are the real and imaginary parts of a complex
+     FFT of half the size, separated by the symmetry of real transforms */
+  const size_t h = n / 2;
+  buffer.resize(h);
+  for (size_t i = 0; i < h; i++) {
+    buffer[i] = Complex(source[2 * i], source[2 * i + 1]);
+  }
+  complex_.transform(buffer.data());
+  for (size_t k = 0; k <= h; k++) {
+    Complex z = buffer[k % h];
+    Complex c = std::conj(buffer[(h - k) % h]);
+    Complex even = 0.5 * (z + c);
+    Complex d = z - c;
+    Complex odd(0.5 * d.imag(), -0.5 * d.real());
+    destination[k] = even + detail::multiply(twiddles_[k], odd);
+  }
+}
+
+const realplan& realplan::cached(const size_t& size) {
+  static std::mutex mutex;
+  static std::map<size_t, std::unique_ptr<realplan>> plans;
+  std::unique_lock<std::mutex> lock(mutex);
+  std::unique_ptr<realplan>& found = plans[size];
+  if (!found) {
+    found.reset(new realplan(size));
+  }
+  return *found;
+}
+
+void taper(
+  ga::type::DoubleVector& window,
+  const size_t& size,
+  const Window& type) {
+  window.resize(size);
+  for (size_t k = 0; k < size; k++) {
+    double x = 2.0 * detail::Pi * static_cast<double>(k) /
+      static_cast<double>(size);
+    switch (type) {
+    case Window::Rectangular:
+      window[k] = 1.0;
+      break;
+    case Window::Hann:
+      window[k] = 0.5 - 0.5 * std::cos(x);
+      break;
+    case Window::Hamming:
+      window[k] = 0.54 - 0.46 * std::cos(x);
+      break;
+    case Window::Blackman:
+      window[k] = 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2.0 * x);
+      break;
+    }
+  }
+}
+
+Options::Options() :
+  Segment(256),
+  Overlap(128),
+  Taper(Window::Hann),
+  Rate(1.0),
+  Detrend(true) {
+}
+
+Spectrum::Spectrum() : Segments(0) {
+}
+
+void welch(
+  Spectrum& spectrum,
+  const double* values,
+  const size_t& count,
+  const Options& options,
+  ga::pool& pool) {
+  detail::Context context;
+  detail::prepare(context, count, options);
+  const size_t bins = context.Bins;
+  const size_t partitions = std::min(context.Segments, detail::Partitions);
+  ga::type::DoubleVector partials(partitions * bins, 0.0);
+  detail::partition(context, pool, [&](size_t p, size_t first) {
+    size_t last = (p + 1) * context.Segments / partitions;
+    ga::type::DoubleVector segment;
+    ComplexVector coefficients;
+    for (size_t s = first; s < last; s++) {
+      detail::density(partials.data() + p * bins, values + s * context.Hop,
+        context, segment, coefficients);
+    }
+  });
+  spectrum.Segments = context.Segments;
+  spectrum.Frequency.resize(bins);
+  spectrum.Power.assign(bins, 0.0);
+  for (size_t p = 0; p < partitions; p++) {
+    for (size_t k = 0; k < bins; k++) {
+      spectrum.Power[k] += partials[p * bins + k];
+    }
+  }
+  for (size_t k = 0; k < bins; k++) {
+    spectrum.Frequency[k] = static_cast<double>(k) * options.Rate /
+      static_cast<double>(options.Segment);
+    spectrum.Power[k] /= static_cast<double>(context.Segments);
+  }
+}
+
+void welch(
+  Spectrum& spectrum,
+  const ga::type::AlignedDoubleVector& column,
+  const Options& options,
+  ga::pool& pool) {
+  welch(spectrum, column.data(), column.size(), options, pool);
+}
+
+void spectrogram(
+  Spectrogram& spectrogram,
+  const double* values,
+  const size_t& count,
+  const Options& options,
+  ga::pool& pool) {
+  detail::Context context;
+  detail::prepare(context, count, options);
+  const size_t bins = context.Bins;
+  const size_t partitions = std::min(context.Segments, detail::Partitions);
+  spectrogram.Power.assign(context.Segments * bins, 0.0);
+  detail::partition(context, pool, [&](size_t p, size_t first) {
+    size_t last = (p + 1) * context.Segments / partitions;
+    ga::type::DoubleVector segment;
+    ComplexVector coefficients;
+    for (size_t s = first; s < last; s++) {
+      detail::density(spectrogram.Power.data() + s * bins,
+        values + s * context.Hop, context, segment, coefficients);
+    }
+  });
+  spectrogram.Frequency.resize(bins);
+  for (size_t k = 0; k < bins; k++) {
+    spectrogram.Frequency[k] = static_cast<double>(k) * options.Rate /
+      static_cast<double>(options.Segment);
+  }
+  spectrogram.Time.resize(context.Segments);
+  for (size_t s = 0; s < context.Segments; s++) {
+    spectrogram.Time[s] = (static_cast<double>(s * context.Hop) +
+      0.5 * static_cast<double>(options.Segment)) / options.Rate;
+  }
+}
+
+void spectrogram(
+  Spectrogram& spectrogram,
+  const ga::type::AlignedDoubleVector& column,
+  const Options& options,
+  ga::pool& pool) {
+  fourier::spectrogram(
+    spectrogram, column.data(), column.size(), options, pool);
+}
+
+namespace detail {
+
+void prepare(Context& context, const size_t& count, const Options& options) {
+  if (options.Segment < 2 || options.Overlap >= options.Segment ||
+    !(options.Rate > 0.0)) {
+    throw ga::exception("The segment, overlap or rate is not valid");
+  }
+  if (count < options.Segment) {
+    throw ga::exception("Fewer values than a segment");
+  }
+  context.Settings = &options;
+  context.Plan = &realplan::cached(options.Segment);
+  taper(context.Window, options.Segment, options.Taper);
+  double energy = 0.0;
+  for (const double& w : context.Window) {
+    energy += w * w;
+  }
+  context.Scale = 1.0 / (options.Rate * energy);
+  context.Bins = options.Segment / 2 + 1;
+  context.Hop = options.Segment - options.Overlap;
+  context.Segments = (count - options.Segment) / context.Hop + 1;
+}
+
+/* Add the one sided density of the segment at values to power, every bin
+   but zero and the Nyquist frequency is doubled for the negative
+   frequencies */
+void density(
+  double* power,
+  const double* values,
+  const Context& context,
+  ga::type::DoubleVector& segment,
+  ComplexVector& coefficients) {
+  const size_t size = context.Settings->Segment;
+  segment.resize(size);
+  coefficients.resize(context.Bins);
+  double mean = 0.0;
+  if (context.Settings->Detrend) {
+    for (size_t i = 0; i < size; i++) {
+      mean += values[i];
+    }
+    mean /= static_cast<double>(size);
+  }
+  const double* window = context.Window.data();
+  for (size_t i = 0; i < size; i++) {
+    segment[i] = (values[i] - mean) * window[i];
+  }
+  context.Plan->forward(coefficients.data(), segment.data());
+  const size_t nyquist = size % 2 == 0 ? context.Bins - 1 : context.Bins;
+  for (size_t k = 0; k < context.Bins; k++) {
+    double scale = k == 0 || k == nyquist ?
+      context.Scale : 2.0 * context.Scale;
+    const Complex& c = coefficients[k];
+    power[k] += (c.real() * c.real() + c.imag() * c.imag()) * scale;
+  }
+}
+
+/* Call function with every partition and its first segment on the pool */
+void partition(
+  const Context& context,
+  ga::pool& pool,
+  const std::function<void(size_t, size_t)>& function) {
+  const size_t partitions = std::min(context.Segments, Partitions);
+  pool.run(partitions, [&](size_t p) {
+    function(p, p * context.Segments / partitions);
+  });
+}
+
+Complex multiply(const Complex& a, const Complex& b) {
+  return Complex(
+    a.real() * b.real() - a.imag() * b.imag(),
+    a.real() * b.imag() + a.imag() * b.real());
+}
+
+ComplexVector& scratch() {
+  static thread_local ComplexVector buffer;
+  return buffer;
+}
+
+} // namespace detail
+
+} // namespace fourier
+} // namespace analysis
+} // namespace gos
@@ -0,0 +1,131 @@
+#include <cmath>
+
+#include <algorithm>
+
+#include <gos/analysis/join.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+namespace gos {
+namespace analysis {
+namespace join {
+
+namespace detail {
+static void sorted(const double* times, const size_t& count);
+static void merge(
+  ::std::int64_t* matches,
+  const double* left,
+  const size_t& leftcount,
+  const double* right,
+  const size_t& rightcount,
+  const Direction& direction,
+  const double& tolerance);
+} // namespace detail
+
+void asof(
+  IndexVector& matches,
+  const double* left,
+  const size_t& leftcount,
+  const double* right,
+  const size_t& rightcount,
+  const Direction& direction,
+  const double& tolerance) {
+  detail::sorted(left, leftcount);
+  detail::sorted(right, rightcount);
+  matches.resize(leftcount);
+  detail::merge(matches.data(), left, leftcount, right, rightcount,
+    direction, tolerance);
+}
+
+void asof(
+  IndexVector& matches,
+  const double* left,
+  const size_t& leftcount,
+  const double* right,
+  const size_t& rightcount,
+  const Direction& direction,
+  const double& tolerance,
+  ::gos::analysis::pool& pool) {
+  detail::sorted(left, leftcount);
+  detail::sorted(right, rightcount);
+  matches.resize(leftcount);
+  const size_t minimum = 1 << 16;
+  size_t partitions = std::max<size_t>(
+    1, std::min(pool.size() * 4, leftcount / minimum));
+  pool.run(partitions, [&](size_t p) {
+    size_t first = leftcount * p / partitions;
+    size_t last = leftcount * (p + 1) / partitions;
+    if (first == last) {
+      return;
+    }
+    /* Only the last right time before the first left time of the
+       partition and the ones after it can be matched */
+    size_t start = static_cast<size_t>(std::lower_bound(
+      right, right + rightcount, left[first]) - right);
+    start = start > 0 ? start - 1 : 0;
+    detail::merge(matches.data() + first, left + first, last - first,
+      right + start, rightcount - start, direction, tolerance);
+    for (size_t i = first; i < last; i++) {
+      if (matches[i] != None) {
+        matches[i] += static_cast<std::int64_t>(start);
+      }
+    }
+  });
+}
+
+namespace detail {
+
+void sorted(const double* times, const size_t& count) {
+  for (size_t i = 1; i < count; i++) {
+    if (times[i] < times[i - 1]) {
+      throw ga::exception("The join times must be in ascending order");
+    }
+  }
+}
+
+/* backward is one past the last right time at or before the left time
+   and forward the first right time at or after it, both only move on */
+void merge(
+  std::int64_t* matches,
+  const double* left,
+  const size_t& leftcount,
+  const double* right,
+  const size_t& rightcount,
+  const Direction& direction,
+  const double& tolerance) {
+  size_t backward = 0, forward = 0;
+  for (size_t i = 0; i < leftcount; i++) {
+    const double time = left[i];
+    while (backward < rightcount && right[backward] <= time) {
+      backward++;
+    }
+    while (forward < rightcount && right[forward] < time) {
+      forward++;
+    }
+    std::int64_t match = None;
+    double distance = 0.0;
+    bool before = backward > 0;
+    bool after = forward < rightcount;
+    if (direction == Direction::Nearest && before && after) {
+      double behind = time - right[backward - 1];
+      double ahead = right[forward] - time;
+      before = behind <= ahead;
+      after = !before;
+    }
+    if (before && direction != Direction::Forward) {
+      match = static_cast<std::int64_t>(backward - 1);
+      distance = time - right[backward - 1];
+    } else if (after && direction != Direction::Backward) {
+      match = static_cast<std::int64_t>(forward);
+      distance = right[forward] - time;
+    }
+    matches[i] = distance <= tolerance ? match : None;
+  }
+}
+
+} // namespace detail
+
+} // namespace join
+} // namespace analysis
+} // namespace gos
@@ -0,0 +1,137 @@
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <string>
+
+#include <gos/analysis/mapping.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+namespace gos {
+namespace analysis {
+
+static void fail(const char* message, const char* filepath);
+
+#ifdef _WIN32
+
+mapping::mapping(const char* filepath) :
+  data_(nullptr),
+  size_(0),
+  file_(INVALID_HANDLE_VALUE),
+  mapping_(nullptr) {
+  file_ = ::CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, nullptr,
+    OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    fail("Failed to open", filepath);
+  }
+  LARGE_INTEGER size;
+  if (!::GetFileSizeEx(file_, &size)) {
+    ::CloseHandle(file_);
+    fail("Failed to get the size of", filepath);
+  }
+  size_ = static_cast<size_t>(size.QuadPart);
+  if (size_ > 0) {
+    mapping_ = ::CreateFileMappingA(
+      file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr) {
+      ::CloseHandle(file_);
+      fail("Failed to map", filepath);
+    }
+    data_ = static_cast<const char*>(
+      ::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr) {
+      ::CloseHandle(mapping_);
+      ::CloseHandle(file_);
+      fail("Failed to map", filepath);
+    }
+  }
+}
+
+mapping::~mapping() {
+  if (data_ != nullptr) {
+    ::UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    ::CloseHandle(mapping_);
+  }
+  if (file_ != INVALID_HANDLE_VALUE) {
+    ::CloseHandle(file_);
+  }
+}
+
+#else
+
+mapping::mapping(const char* filepath) :
+  data_(nullptr),
+  size_(0),
+  file_(-1) {
+  file_ = ::open(filepath, O_RDONLY);
+  if (file_ < 0) {
+    fail("Failed to open", filepath);
+  }
+  struct stat status;
+  if (::fstat(file_, &status) != 0) {
+    ::close(file_);
+    fail("Failed to get the size of", filepath);
+  }
+  size_ = static_cast<size_t>(status.st_size);
+  if (size_ > 0) {
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    /* Fault the pages in up front, the whole file is about to be read */
+    flags |= MAP_POPULATE;
+#endif
+    void* data = ::mmap(nullptr, size_, PROT_READ, flags, file_, 0);
+    if (data == MAP_FAILED) {
+      ::close(file_);
+      fail("Failed to map", filepath);
+    }
+    ::madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(data);
+  }
+}
+
+mapping::~mapping() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<char*>(data_), size_);
+  }
+  if (file_ >= 0) {
+    ::close(file_);
+  }
+}
+
+#endif
+
+const char* mapping::data() const {
+  return data_;
+}
+
+const size_t& mapping::size() const {
+  return size_;
+}
+
+const char* mapping::begin() const {
+  return data_;
+}
+
+const char* mapping::end() const {
+  return data_ + size_;
+}
+
+void fail(const char* message, const char* filepath) {
+  std::string what(message);
+  what += " '";
+  what += filepath;
+  what += "'";
+  throw ga::exception(what.c_str());
+}
+
+} // namespace analysis
+} // namespace gos
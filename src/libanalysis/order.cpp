@@ -0,0 +1,164 @@
+#include <cmath>
+
+#include <gos/analysis/order.h>
+
+namespace gos {
+namespace analysis {
+
+/* Node 0 is the empty sub tree */
+order::order() : nodes_(1, Node{ 0.0, 0, 0, 0, 0 }), root_(0), seed_(2463534242) {
+}
+
+void order::reserve(const size_t& capacity) {
+  nodes_.reserve(capacity + 1);
+  free_.reserve(capacity);
+}
+
+void order::insert(const double& value) {
+  if (std::isnan(value)) {
+    return;
+  }
+  Index left, right;
+  Index node = this->allocate(value);
+  this->split(this->root_, value, left, right);
+  this->root_ = this->merge(this->merge(left, node), right);
+}
+
+bool order::erase(const double& value) {
+  bool found = false;
+  if (std::isnan(value)) {
+    return found;
+  }
+  this->root_ = this->erase(this->root_, value, found);
+  return found;
+}
+
+void order::clear() {
+  this->nodes_.resize(1);
+  this->free_.clear();
+  this->root_ = 0;
+}
+
+size_t order::count() const {
+  return nodes_[root_].Size;
+}
+
+const double& order::select(const size_t& rank) const {
+  size_t remaining = rank;
+  Index index = root_;
+  for (;;) {
+    const Node& node = nodes_[index];
+    Index leftsize = nodes_[node.Left].Size;
+    if (remaining < leftsize) {
+      index = node.Left;
+    } else if (remaining == leftsize || node.Right == 0) {
+      return node.Value;
+    } else {
+      remaining -= leftsize + 1;
+      index = node.Right;
+    }
+  }
+}
+
+size_t order::rank(const double& value) const {
+  size_t result = 0;
+  Index index = root_;
+  while (index != 0) {
+    const Node& node = nodes_[index];
+    if (node.Value < value) {
+      result += static_cast<size_t>(nodes_[node.Left].Size) + 1;
+      index = node.Right;
+    } else {
+      index = node.Left;
+    }
+  }
+  return result;
+}
+
+size_t order::upper(const double& value) const {
+  size_t result = 0;
+  Index index = root_;
+  while (index != 0) {
+    const Node& node = nodes_[index];
+    if (node.Value <= value) {
+      result += static_cast<size_t>(nodes_[node.Left].Size) + 1;
+      index = node.Right;
+    } else {
+      index = node.Left;
+    }
+  }
+  return result;
+}
+
+order::Index order::allocate(const double& value) {
+  /* Xorshift gives the priorities, deterministic from run to run */
+  this->seed_ ^= this->seed_ << 13;
+  this->seed_ ^= this->seed_ >> 17;
+  this->seed_ ^= this->seed_ << 5;
+  Node node{ value, 0, 0, 1, this->seed_ };
+  if (!this->free_.empty()) {
+    Index index = this->free_.back();
+    this->free_.pop_back();
+    this->nodes_[index] = node;
+    return index;
+  }
+  this->nodes_.push_back(node);
+  return static_cast<Index>(this->nodes_.size() - 1);
+}
+
+void order::update(const Index& index) {
+  Node& node = this->nodes_[index];
+  node.Size = this->nodes_[node.Left].Size + this->nodes_[node.Right].Size + 1;
+}
+
+/* Split into the values lower than value and the rest */
+void order::split(Index index, const double& value, Index& left, Index& right) {
+  if (index == 0) {
+    left = right = 0;
+  } else if (this->nodes_[index].Value < value) {
+    this->split(this->nodes_[index].Right, value, this->nodes_[index].Right, right);
+    left = index;
+    this->update(index);
+  } else {
+    this->split(this->nodes_[index].Left, value, left, this->nodes_[index].Left);
+    right = index;
+    this->update(index);
+  }
+}
+
+order::Index order::merge(Index left, Index right) {
+  if (left == 0) {
+    return right;
+  } else if (right == 0) {
+    return left;
+  } else if (this->nodes_[left].Priority > this->nodes_[right].Priority) {
+    this->nodes_[left].Right = this->merge(this->nodes_[left].Right, right);
+    this->update(left);
+    return left;
+  } else {
+    this->nodes_[right].Left = this->merge(left, this->nodes_[right].Left);
+    this->update(right);
+    return right;
+  }
+}
+
+order::Index order::erase(const Index& index, const double& value, bool& found) {
+  if (index == 0) {
+    return 0;
+  }
+  Node& node = this->nodes_[index];
+  if (value < node.Value) {
+    node.Left = this->erase(node.Left, value, found);
+  } else if (node.Value < value) {
+    node.Right = this->erase(node.Right, value, found);
+  } else {
+    found = true;
+    this->free_.push_back(index);
+    return this->merge(node.Left, node.Right);
+  }
+  this->update(index);
+  return index;
+}
+
+} // namespace analysis
+} // namespace gos
@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+
+#include <gos/analysis/pool.h>
+
+namespace gos {
+namespace analysis {
+
+namespace detail {
+struct Queue {
+  ::std::mutex Mutex;
+  ::std::deque<pool::Task> Tasks;
+};
+/* The pool and the index of the worker running on this thread */
+static thread_local const pool* current = nullptr;
+static thread_local size_t worker = 0;
+struct Run {
+  Run(const size_t& count, const pool::IndexFunction& function) :
+    Count(count),
+    Function(function),
+    Next(0),
+    Done(0) {
+  }
+  const size_t Count;
+  const pool::IndexFunction Function;
+  ::std::atomic<size_t> Next;
+  size_t Done;
+  ::std::exception_ptr Exception;
+  ::std::mutex Mutex;
+  ::std::condition_variable Condition;
+};
+static void take(Run& run);
+} // namespace detail
+
+pool::pool() : pool(std::thread::hardware_concurrency()) {
+}
+
+pool::pool(const size_t& threads) : pending_(0), next_(0), stop_(false) {
+  size_t count = threads > 0 ? threads : 1;
+  for (size_t i = 0; i < count; i++) {
+    queues_.emplace_back(new detail::Queue());
+  }
+  for (size_t i = 0; i < count; i++) {
+    threads_.emplace_back(&pool::work, this, i);
+  }
+}
+
+pool::~pool() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+size_t pool::size() const {
+  return threads_.size();
+}
+
+void pool::run(const size_t& count, const IndexFunction& function) {
+  if (count == 0) {
+    return;
+  }
+  std::shared_ptr<detail::Run> run =
+    std::make_shared<detail::Run>(count, function);
+  size_t helpers = std::min(count, threads_.size()) - 1;
+  for (size_t i = 0; i < helpers; i++) {
+    push([run]() { detail::take(*run); });
+  }
+  detail::take(*run);
+  std::unique_lock<std::mutex> lock(run->Mutex);
+  run->Condition.wait(lock, [&run]() { return run->Done == run->Count; });
+  if (run->Exception) {
+    std::rethrow_exception(run->Exception);
+  }
+}
+
+pool& pool::shared() {
+  static pool instance;
+  return instance;
+}
+
+void pool::push(Task task) {
+  size_t index = detail::current == this ?
+    detail::worker : next_.fetch_add(1) % queues_.size();
+  {
+    /* Counted first and under the lock so a worker about to wait sees it
+       and the count never drops below the tasks queued */
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_++;
+  }
+  {
+    detail::Queue& queue = *queues_[index];
+    std::unique_lock<std::mutex> lock(queue.Mutex);
+    queue.Tasks.push_back(std::move(task));
+  }
+  condition_.notify_one();
+}
+
+/* The newest task of the worker or else the oldest task of another */
+bool pool::take(const size_t& worker, Task& task) {
+  size_t count = queues_.size();
+  for (size_t i = 0; i < count; i++) {
+    detail::Queue& queue = *queues_[(worker + i) % count];
+    std::unique_lock<std::mutex> lock(queue.Mutex);
+    if (!queue.Tasks.empty()) {
+      if (i == 0) {
+        task = std::move(queue.Tasks.back());
+        queue.Tasks.pop_back();
+      } else {
+        task = std::move(queue.Tasks.front());
+        queue.Tasks.pop_front();
+      }
+      pending_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void pool::work(const size_t& worker) {
+  detail::current = this;
+  detail::worker = worker;
+  for (;;) {
+    Task task;
+    if (take(worker, task)) {
+      task();
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this]() { return stop_ || pending_ > 0; });
+    if (stop_ && pending_ == 0) {
+      return;
+    }
+  }
+}
+
+namespace detail {
+void take(Run& run) {
+  size_t index;
+  while ((index = run.Next.fetch_add(1)) < run.Count) {
+    try {
+      run.Function(index);
+    } catch (...) {
+      std::unique_lock<std::mutex> lock(run.Mutex);
+      if (!run.Exception) {
+        run.Exception = std::current_exception();
+      }
+    }
+    std::unique_lock<std::mutex> lock(run.Mutex);
+    if (++run.Done == run.Count) {
+      run.Condition.notify_all();
+    }
+  }
+}
+} // namespace detail
+
+} // namespace analysis
+} // namespace gos
@@ -0,0 +1,158 @@
+#include <cmath>
+
+#include <algorithm>
+
+#include <gos/analysis/quantile.h>
+
+namespace ga = ::gos::analysis;
+
+namespace gos {
+namespace analysis {
+
+quantile::quantile() : size_(10), head_(0), count_(0) {
+}
+
+quantile::quantile(const size_t& size) : size_(size), head_(0), count_(0) {
+}
+
+bool quantile::add(const double& value) {
+  if (this->size_ == 0 || std::isnan(value)) {
+    return false;
+  }
+  if (this->buffer_.size() != this->size_) {
+    this->buffer_.resize(this->size_);
+    this->order_.reserve(this->size_);
+  }
+  if (this->count_ < this->size_) {
+    size_t position = this->head_ + this->count_;
+    if (position >= this->size_) {
+      position -= this->size_;
+    }
+    this->buffer_[position] = value;
+    this->count_++;
+  } else {
+    this->order_.erase(this->buffer_[this->head_]);
+    this->buffer_[this->head_] = value;
+    if (++(this->head_) >= this->size_) {
+      this->head_ = 0;
+    }
+  }
+  this->order_.insert(value);
+  return true;
+}
+
+void quantile::set(const size_t& size) {
+  if (size != this->size_) {
+    size_t count = std::min(this->count_, size);
+    ga::type::DoubleVector buffer(size);
+    for (size_t i = 0; i < count; i++) {
+      size_t position = this->head_ + this->count_ - count + i;
+      buffer[i] = this->buffer_[position % this->size_];
+    }
+    this->buffer_.swap(buffer);
+    this->head_ = 0;
+    this->count_ = count;
+    this->order_.clear();
+    this->order_.reserve(size);
+    for (size_t i = 0; i < count; i++) {
+      this->order_.insert(this->buffer_[i]);
+    }
+  }
+  this->size_ = size;
+}
+
+const size_t& quantile::size() const {
+  return size_;
+}
+
+size_t quantile::count() const {
+  return count_;
+}
+
+void quantile::clear() {
+  this->head_ = 0;
+  this->count_ = 0;
+  this->order_.clear();
+}
+
+double quantile::value(const double& probability) const {
+  if (count_ == 0) {
+    return 0.0;
+  }
+  double position = std::min(std::max(probability, 0.0), 1.0) *
+    static_cast<double>(count_ - 1);
+  size_t lower = static_cast<size_t>(::floor(position));
+  double fraction = position - static_cast<double>(lower);
+  double result = order_.select(lower);
+  if (fraction > 0.0 && lower + 1 < count_) {
+    result += fraction * (order_.select(lower + 1) - result);
+  }
+  return result;
+}
+
+void quantile::values(
+  ::gos::analysis::type::DoubleVector& values,
+  const ::gos::analysis::type::DoubleVector& probabilities) const {
+  values.resize(probabilities.size());
+  for (size_t i = 0; i < probabilities.size(); i++) {
+    values[i] = value(probabilities[i]);
+  }
+}
+
+double quantile::median() const {
+  return value(0.5);
+}
+
+/* The absolute deviations are the union of two sorted sequences, the
+   distances from the median down to the lower values and up to the rest.
+   The k-th smallest distance is found by a binary search on how many come
+   from the lower sequence, so the mad is O(log^2 w) without a copy. */
+double quantile::mad() const {
+  if (count_ < 2) {
+    return 0.0;
+  }
+  double median = this->median();
+  size_t lower = order_.rank(median);
+  size_t half = count_ / 2;
+  if (count_ % 2 == 0) {
+    return (distance(half - 1, median, lower) +
+      distance(half, median, lower)) / 2.0;
+  } else {
+    return distance(half, median, lower);
+  }
+}
+
+double quantile::distance(
+  const size_t& rank,
+  const double& median,
+  const size_t& lower) const {
+  size_t upper = count_ - lower;
+  size_t wanted = rank + 1;
+  size_t low = wanted > upper ? wanted - upper : 0;
+  size_t high = std::min(wanted, lower);
+  /* The i-th lower distance is median - select(lower - 1 - i) and the j-th
+     upper distance is select(lower + j) - median */
+  while (low < high) {
+    size_t i = (low + high) / 2;
+    size_t j = wanted - i;
+    if (median - order_.select(lower - 1 - i) <
+      order_.select(lower + j - 1) - median) {
+      low = i + 1;
+    } else {
+      high = i;
+    }
+  }
+  size_t i = low;
+  size_t j = wanted - i;
+  double result = 0.0;
+  if (i > 0) {
+    result = median - order_.select(lower - i);
+  }
+  if (j > 0) {
+    result = std::max(result, order_.select(lower + j - 1) - median);
+  }
+  return result;
+}
+
+} // namespace analysis
+} // namespace gos
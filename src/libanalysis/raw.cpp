@@ -0,0 +1,239 @@
+#include <charconv>
+#include <cstdio>
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gos/analysis/raw.h>
+#include <gos/analysis/tc.h>
+#include <gos/analysis/binary.h>
+#include <gos/analysis/text.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+namespace fs = ::std::filesystem;
+
+namespace gos {
+namespace analysis {
+namespace tc {
+namespace raw {
+
+namespace detail {
+/* Closes the file when it goes out of scope */
+struct File {
+  File(const char* filepath, const char* mode);
+  ~File();
+  /* False if the buffered output could not be written */
+  bool close();
+  ::std::FILE* Handle;
+};
+/* Removes the file, if it still exists, when it goes out of scope */
+struct Temporary {
+  ~Temporary();
+  ::std::string Path;
+};
+static void open(const File& file, const char* filepath);
+static void append(::std::string& text, const double& value, const char& end);
+static void flush(::std::string& text, const File& file);
+} // namespace detail
+
+Layout::Layout() :
+  Time(0),
+  Control(2),
+  Temperature(3),
+  TicksPerSecond(1000.0) {
+}
+
+size_t convert(
+  const char* rawpath,
+  const char* destinationpath,
+  const Output& output,
+  const Layout& layout) {
+  const size_t blocksize = 1 << 20;
+  const size_t columns = std::max(
+    std::max(layout.Time, layout.Control), layout.Temperature) + 1;
+  detail::File source(rawpath, "rb");
+  detail::open(source, rawpath);
+  /* Both outputs are written next to the destination and renamed over it
+     at the end, so a failed conversion leaves the destination as it was */
+  detail::Temporary temporary;
+  std::string text;
+  std::unique_ptr<binary::writer> writer;
+  if (output == Output::Text) {
+    temporary.Path = binary::temporary(destinationpath);
+    text.reserve(blocksize + 256);
+    text += "time,control,temperature\n";
+  } else {
+    writer = std::make_unique<binary::writer>(destinationpath);
+  }
+  detail::File destination(
+    output == Output::Text ? temporary.Path.c_str() : nullptr, "wb");
+  if (output == Output::Text) {
+    detail::open(destination, temporary.Path.c_str());
+  }
+  std::vector<char> buffer(blocksize);
+  std::vector<double> values(columns);
+  size_t begin = 0, end = 0, count = 0;
+  bool eof = false;
+  double origin = 0.0;
+  while (!eof || begin < end) {
+    if (!eof) {
+      /* Move what is left to the front and read the next block after it,
+         the buffer grows only for a line longer than the buffer */
+      std::copy(buffer.begin() + begin, buffer.begin() + end, buffer.begin());
+      end -= begin;
+      begin = 0;
+      if (end == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+      }
+      size_t read = std::fread(
+        buffer.data() + end, 1, buffer.size() - end, source.Handle);
+      end += read;
+      eof = read == 0;
+    }
+    const char* first = buffer.data() + begin;
+    const char* last = buffer.data() + end;
+    if (!eof) {
+      /* Only convert complete lines unless the end of the file is reached */
+      while (last > first && *(last - 1) != '\n') {
+        last--;
+      }
+    }
+    const char* cursor = first;
+    while (cursor < last) {
+      const char* lineend = ga::text::end(cursor, last);
+      const char* field = cursor;
+      cursor = lineend < last ? ga::text::next(lineend, last) : last;
+      if (field == lineend) {
+        continue;
+      }
+      for (size_t i = 0; i < columns; i++) {
+        if (!ga::text::number(field, lineend, values[i])) {
+          throw ga::exception("Invalid number in the raw file");
+        }
+        if (i + 1 < columns && !ga::text::skip(field, lineend)) {
+          throw ga::exception("Missing a column in the raw file");
+        }
+      }
+      if (count == 0) {
+        origin = values[layout.Time];
+      }
+      double time = (values[layout.Time] - origin) / layout.TicksPerSecond;
+      if (output == Output::Text) {
+        detail::append(text, time, ',');
+        detail::append(text, values[layout.Control], ',');
+        detail::append(text, values[layout.Temperature], '\n');
+        if (text.size() >= blocksize) {
+          detail::flush(text, destination);
+        }
+      } else {
+        writer->add(time, values[layout.Control], values[layout.Temperature]);
+      }
+      count++;
+    }
+    begin = static_cast<size_t>(cursor - buffer.data());
+  }
+  if (output == Output::Text) {
+    detail::flush(text, destination);
+    if (!destination.close()) {
+      throw ga::exception("Failed to write the standard file");
+    }
+    std::error_code error;
+    fs::rename(temporary.Path, destinationpath, error);
+    if (error) {
+      throw ga::exception("Failed to replace the standard file");
+    }
+  } else {
+    writer->close();
+  }
+  return count;
+}
+
+size_t convertdirectory(
+  const char* rawdirectory,
+  const char* destinationdirectory,
+  const Output& output,
+  const Layout& layout,
+  ::gos::analysis::pool& pool) {
+  std::vector<fs::path> paths;
+  for (const fs::directory_entry& entry :
+    fs::directory_iterator(rawdirectory)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".csv") {
+      paths.push_back(entry.path());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+  fs::create_directories(destinationdirectory);
+  const char* extension = output == Output::Text ? ".csv" : ".tcb";
+  pool.run(paths.size(), [&](size_t i) {
+    fs::path destination(destinationdirectory);
+    destination /= paths[i].stem();
+    destination += extension;
+    convert(paths[i].string().c_str(), destination.string().c_str(),
+      output, layout);
+  });
+  return paths.size();
+}
+
+namespace detail {
+
+File::File(const char* filepath, const char* mode) :
+  Handle(filepath != nullptr ? std::fopen(filepath, mode) : nullptr) {
+}
+
+File::~File() {
+  close();
+}
+
+bool File::close() {
+  if (Handle == nullptr) {
+    return true;
+  }
+  int result = std::fclose(Handle);
+  Handle = nullptr;
+  return result == 0;
+}
+
+Temporary::~Temporary() {
+  if (!Path.empty()) {
+    std::error_code error;
+    fs::remove(Path, error);
+  }
+}
+
+void open(const File& file, const char* filepath) {
+  if (file.Handle == nullptr) {
+    std::string what("Failed to open '");
+    what += filepath;
+    what += "'";
+    throw ga::exception(what.c_str());
+  }
+}
+
+/* The shortest text that reads back as the same value */
+void append(std::string& text, const double& value, const char& end) {
+  char buffer[32];
+  std::to_chars_result result =
+    std::to_chars(buffer, buffer + sizeof(buffer), value);
+  text.append(buffer, result.ptr);
+  text += end;
+}
+
+void flush(std::string& text, const File& file) {
+  if (!text.empty() &&
+    std::fwrite(text.data(), 1, text.size(), file.Handle) != text.size()) {
+    throw ga::exception("Failed to write the standard file");
+  }
+  text.clear();
+}
+
+} // namespace detail
+
+} // namespace raw
+} // namespace tc
+} // namespace analysis
+} // namespace gos
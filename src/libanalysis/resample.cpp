@@ -0,0 +1,270 @@
+#include <cmath>
+
+#include <limits>
+#include <vector>
+
+#include <gos/analysis/resample.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+namespace gos {
+namespace analysis {
+namespace resample {
+
+namespace detail {
+static void sorted(const double* time, const size_t& count);
+static void locate(
+  ::std::vector<size_t>& lower,
+  ::std::vector<double>& weight,
+  const double* time,
+  const size_t& count,
+  const Grid& grid);
+static void interpolate(
+  double* destination,
+  const double* column,
+  const size_t* lower,
+  const double* weight,
+  const size_t& count);
+static void pick(
+  double* destination,
+  const double* column,
+  const size_t* lower,
+  const double* weight,
+  const size_t& count);
+static void average(
+  double* const* destinations,
+  const double* const* columns,
+  const size_t& width,
+  const double* time,
+  const size_t& count,
+  const Grid& grid);
+} // namespace detail
+
+double Grid::at(const size_t& index) const {
+  return Start + static_cast<double>(index) * Step;
+}
+
+Grid grid(
+  const double* time,
+  const size_t& count,
+  const double& step,
+  const Mode& mode) {
+  if (!(step > 0.0) || !std::isfinite(step)) {
+    throw ga::exception("The resample step must be positive");
+  }
+  detail::sorted(time, count);
+  Grid result = { 0.0, step, 0 };
+  if (count == 0) {
+    return result;
+  }
+  double first = time[0] / step;
+  double last = time[count - 1] / step;
+  double start = mode == Mode::Mean ? std::floor(first) : std::ceil(first);
+  double span = std::floor(last) - start;
+  /* Finite times over a tiny step can still be too many points */
+  if (!std::isfinite(span) ||
+    span >= static_cast<double>(std::numeric_limits<size_t>::max())) {
+    throw ga::exception("The resample grid has too many points");
+  }
+  result.Start = start * step;
+  result.Count = start > last ? 0 : static_cast<size_t>(span) + 1;
+  /* Rounding can leave an end of the grid just on the wrong side of the
+     times, move it by a step so resample sees them as inside */
+  if (mode == Mode::Mean) {
+    if (result.Start > time[0]) {
+      result.Start = (start - 1.0) * step;
+      result.Count++;
+    }
+    if (result.at(result.Count) <= time[count - 1]) {
+      result.Count++;
+    }
+  } else if (result.Count > 0) {
+    if (result.Start < time[0]) {
+      result.Start = (start + 1.0) * step;
+      result.Count--;
+    }
+    if (result.Count > 0 && result.at(result.Count - 1) > time[count - 1]) {
+      result.Count--;
+    }
+  }
+  return result;
+}
+
+void resample(
+  double* const* destinations,
+  const double* const* columns,
+  const size_t& width,
+  const double* time,
+  const size_t& count,
+  const Grid& grid,
+  const Mode& mode) {
+  detail::sorted(time, count);
+  if (grid.Count == 0) {
+    return;
+  }
+  if (count == 0) {
+    for (size_t c = 0; c < width; c++) {
+      for (size_t i = 0; i < grid.Count; i++) {
+        destinations[c][i] = std::numeric_limits<double>::quiet_NaN();
+      }
+    }
+    return;
+  }
+  if (mode == Mode::Mean) {
+    detail::average(destinations, columns, width, time, count, grid);
+    return;
+  }
+  std::vector<size_t> lower;
+  std::vector<double> weight;
+  detail::locate(lower, weight, time, count, grid);
+  for (size_t c = 0; c < width; c++) {
+    if (mode == Mode::Linear && count > 1) {
+      detail::interpolate(destinations[c], columns[c], lower.data(),
+        weight.data(), grid.Count);
+    } else {
+      detail::pick(destinations[c], columns[c], lower.data(),
+        weight.data(), grid.Count);
+    }
+  }
+}
+
+void resample(
+  ga::tc::StandardFrame& destination,
+  const ga::tc::StandardFrame& source,
+  const double& step,
+  const Mode& mode) {
+  Grid grid = resample::grid(
+    source.Time.data(), source.size(), step, mode);
+  destination.resize(grid.Count);
+  double* time = destination.Time.data();
+  for (size_t i = 0; i < grid.Count; i++) {
+    time[i] = grid.at(i);
+  }
+  double* destinations[] = {
+    destination.Control.data(), destination.Temperature.data() };
+  const double* columns[] = {
+    source.Control.data(), source.Temperature.data() };
+  resample(destinations, columns, 2, source.Time.data(), source.size(),
+    grid, mode);
+}
+
+namespace detail {
+
+/* Ascending, and finite as the ends are */
+void sorted(const double* time, const size_t& count) {
+  if (count > 0 &&
+    (!std::isfinite(time[0]) || !std::isfinite(time[count - 1]))) {
+    throw ga::exception("The resample times must be finite");
+  }
+  for (size_t i = 1; i < count; i++) {
+    if (!(time[i] >= time[i - 1])) {
+      throw ga::exception("The resample times must be in ascending order");
+    }
+  }
+}
+
+/* For every grid time the last sample at or before it, at most the one
+   before the last sample, and the weight of the sample after that. The
+   weight is NaN before the first sample and above 1 after the last. */
+void locate(
+  std::vector<size_t>& lower,
+  std::vector<double>& weight,
+  const double* time,
+  const size_t& count,
+  const Grid& grid) {
+  lower.resize(grid.Count);
+  weight.resize(grid.Count);
+  size_t j = 0;
+  const size_t last = count > 1 ? count - 2 : 0;
+  for (size_t i = 0; i < grid.Count; i++) {
+    double at = grid.at(i);
+    while (j < last && time[j + 1] <= at) {
+      j++;
+    }
+    double span = count > 1 ? time[j + 1] - time[j] : 0.0;
+    double w = span > 0.0 ? (at - time[j]) / span : 0.0;
+    lower[i] = j;
+    weight[i] = at < time[0] ? std::numeric_limits<double>::quiet_NaN() : w;
+  }
+}
+
+/* The arithmetic is branch free over arrays so it can be vectorised, the
+   loads from column are a gather. NaN outside the samples. */
+void interpolate(
+  double* destination,
+  const double* column,
+  const size_t* lower,
+  const double* weight,
+  const size_t& count) {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const double* after = column + 1;
+  for (size_t i = 0; i < count; i++) {
+    double before = column[lower[i]];
+    double value = before + weight[i] * (after[lower[i]] - before);
+    destination[i] = weight[i] <= 1.0 ? value : nan;
+  }
+}
+
+/* The weight is at least 1 when the grid time is at or after the sample
+   after lower. NaN before the first sample. */
+void pick(
+  double* destination,
+  const double* column,
+  const size_t* lower,
+  const double* weight,
+  const size_t& count) {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  for (size_t i = 0; i < count; i++) {
+    double value = column[lower[i] + (weight[i] >= 1.0 ? 1 : 0)];
+    destination[i] = weight[i] >= 0.0 ? value : nan;
+  }
+}
+
+void average(
+  double* const* destinations,
+  const double* const* columns,
+  const size_t& width,
+  const double* time,
+  const size_t& count,
+  const Grid& grid) {
+  /* A sample outside the grid gets the bin Count and is skipped, one
+     inside is only clamped against the rounding of its bin */
+  std::vector<size_t> bins(count);
+  std::vector<size_t> counts(grid.Count, 0);
+  const double inverse = 1.0 / grid.Step;
+  const double end = grid.at(grid.Count);
+  for (size_t j = 0; j < count; j++) {
+    if (!(time[j] >= grid.Start && time[j] < end)) {
+      bins[j] = grid.Count;
+      continue;
+    }
+    double bin = std::floor((time[j] - grid.Start) * inverse);
+    size_t index = bin < 0.0 ? 0 : static_cast<size_t>(bin);
+    bins[j] = index < grid.Count ? index : grid.Count - 1;
+    counts[bins[j]]++;
+  }
+  for (size_t c = 0; c < width; c++) {
+    double* destination = destinations[c];
+    const double* column = columns[c];
+    for (size_t i = 0; i < grid.Count; i++) {
+      destination[i] = 0.0;
+    }
+    for (size_t j = 0; j < count; j++) {
+      if (bins[j] < grid.Count) {
+        destination[bins[j]] += column[j];
+      }
+    }
+    for (size_t i = 0; i < grid.Count; i++) {
+      destination[i] = counts[i] > 0 ?
+        destination[i] / static_cast<double>(counts[i]) :
+        std::numeric_limits<double>::quiet_NaN();
+    }
+  }
+}
+
+} // namespace detail
+
+} // namespace resample
+} // namespace analysis
+} // namespace gos
@@ -0,0 +1,219 @@
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+
+#include <gos/analysis/simulation.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+namespace gos {
+namespace analysis {
+namespace simulation {
+
+namespace detail {
+/* Candidates simulated together, the loops over the lanes have a fixed
+   count so they are vectorised */
+static const size_t Lanes = 8;
+static void validate(const Plant& plant, const Options& options);
+static void block(
+  Score* scores,
+  const Plant& plant,
+  const Gains* gains,
+  const size_t& count,
+  const Options& options);
+} // namespace detail
+
+Plant::Plant() :
+  Delay(0),
+  Offset(0.0) {
+}
+
+Plant discretize(
+  const ga::fopdt::Model& model,
+  const double& before,
+  const double& step) {
+  if (!(step > 0.0) || !(model.TimeConstant > 0.0)) {
+    throw ga::exception(
+      "The step and the time constant of the plant must be positive");
+  }
+  double a = std::exp(-step / model.TimeConstant);
+  Plant plant;
+  plant.A.assign(1, a);
+  plant.B.assign(1, model.Gain * (1.0 - a));
+  plant.Delay = static_cast<size_t>(
+    std::lround(std::max(model.DeadTime, 0.0) / step));
+  plant.Offset = model.Offset - model.Gain * before;
+  return plant;
+}
+
+Plant discretize(
+  const ga::fopdt::Identification& identification,
+  const double& step) {
+  return discretize(identification.Fit, identification.Change.Before, step);
+}
+
+Options::Options() :
+  Step(1.0),
+  Samples(1200),
+  Setpoint(100.0),
+  Minimum(0.0),
+  Maximum(255.0),
+  Band(0.02) {
+}
+
+Score::Score() :
+  Iae(0.0),
+  Ise(0.0),
+  Overshoot(0.0),
+  Settling(0.0) {
+}
+
+Score simulate(const Plant& plant, const Gains& gains, const Options& options) {
+  detail::validate(plant, options);
+  Score score;
+  detail::block(&score, plant, &gains, 1, options);
+  return score;
+}
+
+void simulate(
+  ScoreVector& scores,
+  const Plant& plant,
+  const GainsVector& candidates,
+  const Options& options,
+  ga::pool& pool) {
+  detail::validate(plant, options);
+  scores.assign(candidates.size(), Score());
+  size_t blocks = (candidates.size() + detail::Lanes - 1) / detail::Lanes;
+  pool.run(blocks, [&](size_t i) {
+    size_t first = i * detail::Lanes;
+    size_t count = std::min(detail::Lanes, candidates.size() - first);
+    detail::block(scores.data() + first, plant, candidates.data() + first,
+      count, options);
+  });
+}
+
+void grid(
+  GainsVector& candidates,
+  const std::vector<double>& kp,
+  const std::vector<double>& ki,
+  const std::vector<double>& kd) {
+  candidates.clear();
+  candidates.reserve(kp.size() * ki.size() * kd.size());
+  for (const double& p : kp) {
+    for (const double& i : ki) {
+      for (const double& d : kd) {
+        Gains gains;
+        gains.Kp = p;
+        gains.Ki = i;
+        gains.Kd = d;
+        candidates.push_back(gains);
+      }
+    }
+  }
+}
+
+namespace detail {
+
+void validate(const Plant& plant, const Options& options) {
+  if (plant.A.empty() || plant.B.empty()) {
+    throw ga::exception("The plant needs A and B coefficients");
+  }
+  if (!(options.Step > 0.0) || !(options.Maximum >= options.Minimum)) {
+    throw ga::exception("The simulation step or saturation is not valid");
+  }
+}
+
+/* The state of every lane is in arrays of Lanes and the histories of the
+   plant are rings shared by the lanes, as the time is the same in all of
+   them. Lanes past count repeat the first candidate. */
+void block(
+  Score* scores,
+  const Plant& plant,
+  const Gains* gains,
+  const size_t& count,
+  const Options& options) {
+  const size_t na = plant.A.size();
+  const size_t nb = plant.B.size();
+  const size_t nu = plant.Delay + nb;
+  const double h = options.Step;
+  const double setpoint = options.Setpoint - plant.Offset;
+  const double change = std::fabs(setpoint);
+  const double direction = setpoint < 0.0 ? -1.0 : 1.0;
+  const double band = options.Band * change;
+  const double low = options.Minimum;
+  const double high = options.Maximum;
+  double kp[Lanes], ki[Lanes], kd[Lanes];
+  double integral[Lanes], previous[Lanes];
+  double iae[Lanes], ise[Lanes], peak[Lanes], settled[Lanes];
+  for (size_t l = 0; l < Lanes; l++) {
+    const Gains& g = gains[l < count ? l : 0];
+    kp[l] = g.Kp;
+    ki[l] = g.Ki * h;
+    kd[l] = g.Kd / h;
+    integral[l] = 0.0;
+    previous[l] = 0.0;
+    iae[l] = 0.0;
+    ise[l] = 0.0;
+    peak[l] = 0.0;
+    settled[l] = 0.0;
+  }
+  std::vector<double> ys(na * Lanes, 0.0);
+  std::vector<double> us(nu * Lanes, 0.0);
+  for (size_t k = 0; k < options.Samples; k++) {
+    double y[Lanes];
+    for (size_t l = 0; l < Lanes; l++) {
+      y[l] = 0.0;
+    }
+    for (size_t i = 0; i < na; i++) {
+      const double a = plant.A[i];
+      const double* history = ys.data() + ((k + na - 1 - i) % na) * Lanes;
+      for (size_t l = 0; l < Lanes; l++) {
+        y[l] += a * history[l];
+      }
+    }
+    for (size_t j = 0; j < nb; j++) {
+      const double b = plant.B[j];
+      const double* history = us.data() +
+        ((k + nu - 1 - plant.Delay - j) % nu) * Lanes;
+      for (size_t l = 0; l < Lanes; l++) {
+        y[l] += b * history[l];
+      }
+    }
+    double* yk = ys.data() + (k % na) * Lanes;
+    double* uk = us.data() + (k % nu) * Lanes;
+    const double outside = static_cast<double>(k + 1) * h;
+    for (size_t l = 0; l < Lanes; l++) {
+      double e = setpoint - y[l];
+      double derivative = k == 0 ? 0.0 : kd[l] * (y[l] - previous[l]);
+      double next = integral[l] + ki[l] * e;
+      double free = kp[l] * e + next - derivative;
+      double u = std::min(std::max(free, low), high);
+      /* Integrate only while the control is not saturated */
+      integral[l] = u == free ? next : integral[l];
+      previous[l] = y[l];
+      yk[l] = y[l];
+      uk[l] = u;
+      double magnitude = std::fabs(e);
+      iae[l] += magnitude * h;
+      ise[l] += e * e * h;
+      peak[l] = std::max(peak[l], -direction * e);
+      settled[l] = magnitude > band ? outside : settled[l];
+    }
+  }
+  const double end = static_cast<double>(options.Samples) * h;
+  for (size_t l = 0; l < count; l++) {
+    scores[l].Iae = iae[l];
+    scores[l].Ise = ise[l];
+    scores[l].Overshoot = change > 0.0 ? peak[l] / change : 0.0;
+    scores[l].Settling = settled[l] >= end && end > 0.0 ?
+      std::numeric_limits<double>::infinity() : settled[l];
+  }
+}
+
+} // namespace detail
+
+} // namespace simulation
+} // namespace analysis
+} // namespace gos
@@ -1,7 +1,19 @@
+#include <cmath>
+
+#include <algorithm>
+#include <limits>
+
 #include <csv.h>
 
 #include <gos/analysis/tc.h>
+#include <gos/analysis/binary.h>
+#include <gos/analysis/text.h>
+#include <gos/analysis/mapping.h>
+#include <gos/analysis/pool.h>
+#include <gos/analysis/exception.h>
 #include <gos/analysis/window.h>
+#include <gos/analysis/quantile.h>
+#include <gos/analysis/bivariate.h>
 
 namespace ga = ::gos::analysis;
 
@@ -9,6 +21,41 @@ namespace gos {
 namespace analysis {
 namespace tc {
 
+namespace detail {
+/* The role of every column up to the last one needed, -1 for a column
+   that is not used, otherwise 0 for time, 1 for control and 2 for
+   temperature */
+typedef ::std::vector<int> Roles;
+static void stream(StandardVector& vector, const char* filepath);
+static void cached(StandardFrame& frame, const char* filepath);
+static void roles(Roles& roles, const char* first, const char* last);
+static Compact compact(const Standard& standard);
+template<typename Destination> static void mapped(
+  Destination& destination,
+  const char* filepath,
+  const Parser& parser);
+template<typename Destination> static size_t rows(
+  Destination& destination,
+  const char*& cursor,
+  const char* last,
+  const Roles& roles,
+  const size_t& limit = static_cast<size_t>(-1));
+template<typename Destination> static void parallel(
+  Destination& destination,
+  const char* first,
+  const char* last,
+  const Roles& roles,
+  ::gos::analysis::pool& pool);
+static void place(
+  StandardVector& destination,
+  const StandardVector& source,
+  const size_t& offset);
+static void place(
+  StandardFrame& destination,
+  const StandardFrame& source,
+  const size_t& offset);
+} // namespace detail
+
 Standard::Standard() :
   Time(0.0),
   Control(0.0),
@@ -39,16 +86,308 @@ Standard& Standard::operator=(const Standard& standard) {
   return *this;
 }
 
+size_t StandardFrame::size() const {
+  return Time.size();
+}
+
+bool StandardFrame::empty() const {
+  return Time.empty();
+}
+
+void StandardFrame::reserve(const size_t& size) {
+  Time.reserve(size);
+  Control.reserve(size);
+  Temperature.reserve(size);
+}
+
+void StandardFrame::resize(const size_t& size) {
+  Time.resize(size);
+  Control.resize(size);
+  Temperature.resize(size);
+}
+
+void StandardFrame::clear() {
+  Time.clear();
+  Control.clear();
+  Temperature.clear();
+}
+
+void StandardFrame::emplace_back(
+  const double& time,
+  const double& control,
+  const double& temperature) {
+  Time.push_back(time);
+  Control.push_back(control);
+  Temperature.push_back(temperature);
+}
+
+void StandardFrame::push_back(const Standard& standard) {
+  emplace_back(standard.Time, standard.Control, standard.Temperature);
+}
+
+Standard StandardFrame::row(const size_t& index) const {
+  return Standard(Time[index], Control[index], Temperature[index]);
+}
+
+void convert(StandardFrame& frame, const StandardVector& vector) {
+  size_t size = vector.size();
+  frame.resize(size);
+  double* time = frame.Time.data();
+  double* control = frame.Control.data();
+  double* temperature = frame.Temperature.data();
+  for (size_t i = 0; i < size; i++) {
+    time[i] = vector[i].Time;
+    control[i] = vector[i].Control;
+    temperature[i] = vector[i].Temperature;
+  }
+}
+
+void convert(StandardVector& vector, const StandardFrame& frame) {
+  size_t size = frame.size();
+  vector.resize(size);
+  for (size_t i = 0; i < size; i++) {
+    vector[i].Time = frame.Time[i];
+    vector[i].Control = frame.Control[i];
+    vector[i].Temperature = frame.Temperature[i];
+  }
+}
+
+static_assert(sizeof(Compact) == 8, "The compact row must be 8 bytes");
+
+double Compact::time() const {
+  return static_cast<double>(Time) / static_cast<double>(TicksPerSecond);
+}
+
+double Compact::control() const {
+  return static_cast<double>(Control);
+}
+
+double Compact::temperature() const {
+  return static_cast<double>(Temperature) /
+    static_cast<double>(StepsPerDegree);
+}
+
+bool fits(const Standard& standard) {
+  double ticks = ::round(standard.Time * Compact::TicksPerSecond);
+  double steps = ::round(standard.Temperature * Compact::StepsPerDegree);
+  return
+    ticks >= 0.0 &&
+    ticks <= static_cast<double>(std::numeric_limits<std::uint32_t>::max()) &&
+    ticks / Compact::TicksPerSecond == standard.Time &&
+    standard.Control >= 0.0 &&
+    standard.Control <= 255.0 &&
+    ::round(standard.Control) == standard.Control &&
+    steps >= static_cast<double>(std::numeric_limits<std::int16_t>::min()) &&
+    steps <= static_cast<double>(std::numeric_limits<std::int16_t>::max()) &&
+    steps / Compact::StepsPerDegree == standard.Temperature;
+}
+
+void convert(CompactVector& compact, const StandardVector& vector) {
+  CompactVector result;
+  result.reserve(vector.size());
+  for (const Standard& standard : vector) {
+    result.push_back(detail::compact(standard));
+  }
+  compact.swap(result);
+}
+
+void convert(CompactVector& compact, const StandardFrame& frame) {
+  CompactVector result;
+  result.reserve(frame.size());
+  for (size_t i = 0; i < frame.size(); i++) {
+    result.push_back(detail::compact(frame.row(i)));
+  }
+  compact.swap(result);
+}
+
+void convert(StandardVector& vector, const CompactVector& compact) {
+  size_t size = compact.size();
+  vector.resize(size);
+  for (size_t i = 0; i < size; i++) {
+    vector[i].Time = compact[i].time();
+    vector[i].Control = compact[i].control();
+    vector[i].Temperature = compact[i].temperature();
+  }
+}
+
 void parse(StandardVector& vector, const char* filepath) {
-  ::io::CSVReader<3> csvreader(filepath);
-  csvreader.read_header(
-    io::ignore_extra_column,
-    "time",
-    "control",
-    "temperature");
-  double time, control, temperature;
-  while (csvreader.read_row(time, control, temperature)) {
-    vector.push_back(Standard(time, control, temperature));
+  parse(vector, filepath, Parser::Stream);
+}
+
+void parse(
+  StandardVector& vector,
+  const char* filepath,
+  const Parser& parser) {
+  switch (parser) {
+  case Parser::Stream:
+    detail::stream(vector, filepath);
+    break;
+  case Parser::Mapped:
+  case Parser::Parallel:
+    detail::mapped(vector, filepath, parser);
+    break;
+  case Parser::Cached: {
+    StandardFrame frame;
+    detail::cached(frame, filepath);
+    vector.reserve(vector.size() + frame.size());
+    for (size_t i = 0; i < frame.size(); i++) {
+      vector.push_back(frame.row(i));
+    }
+    break;
+  }
+  }
+}
+
+void parse(
+  StandardFrame& frame,
+  const char* filepath,
+  const Parser& parser) {
+  if (parser == Parser::Stream) {
+    StandardVector vector;
+    detail::stream(vector, filepath);
+    frame.reserve(frame.size() + vector.size());
+    for (const Standard& standard : vector) {
+      frame.push_back(standard);
+    }
+  } else if (parser == Parser::Cached) {
+    detail::cached(frame, filepath);
+  } else {
+    detail::mapped(frame, filepath, parser);
+  }
+}
+
+reader::reader(const char* filepath, const size_t& batchsize) :
+  file_(nullptr),
+  buffer_(1 << 20),
+  begin_(0),
+  end_(0),
+  batchsize_(batchsize > 0 ? batchsize : 1),
+  count_(0),
+  eof_(false) {
+  file_ = std::fopen(filepath, "rb");
+  if (file_ == nullptr) {
+    std::string what("Failed to open '");
+    what += filepath;
+    what += "'";
+    throw ga::exception(what.c_str());
+  }
+  const char* first;
+  const char* header;
+  for (;;) {
+    first = buffer_.data() + begin_;
+    header = ga::text::next(first, buffer_.data() + end_);
+    if ((header > first && *(header - 1) == '\n') || !fill()) {
+      break;
+    }
+  }
+  if (header == first) {
+    std::fclose(file_);
+    throw ga::exception("The standard file has no header");
+  }
+  try {
+    detail::roles(roles_, first, header);
+  } catch (...) {
+    std::fclose(file_);
+    throw;
+  }
+  begin_ = static_cast<size_t>(header - buffer_.data());
+}
+
+reader::~reader() {
+  if (file_ != nullptr) {
+    std::fclose(file_);
+  }
+}
+
+bool reader::next(StandardVector& batch) {
+  return read(batch);
+}
+
+bool reader::next(StandardFrame& batch) {
+  return read(batch);
+}
+
+const size_t& reader::batchsize() const {
+  return batchsize_;
+}
+
+const size_t& reader::count() const {
+  return count_;
+}
+
+template<typename Batch> bool reader::read(Batch& batch) {
+  batch.clear();
+  batch.reserve(batchsize_);
+  size_t count = 0;
+  while (count < batchsize_) {
+    /* Only parse complete lines unless the end of the file is reached */
+    const char* first = buffer_.data() + begin_;
+    const char* last = buffer_.data() + end_;
+    if (!eof_) {
+      const char* complete = last;
+      while (complete > first && *(complete - 1) != '\n') {
+        complete--;
+      }
+      last = complete;
+    }
+    const char* cursor = first;
+    count += detail::rows(batch, cursor, last, roles_, batchsize_ - count);
+    begin_ = static_cast<size_t>(cursor - buffer_.data());
+    if (count < batchsize_ && !fill()) {
+      break;
+    }
+  }
+  count_ += count;
+  return count > 0;
+}
+
+/* Move what is left to the front of the buffer and read the next block
+   after it, the buffer grows only for a line longer than the buffer */
+bool reader::fill() {
+  if (eof_) {
+    return false;
+  }
+  size_t left = end_ - begin_;
+  if (begin_ > 0) {
+    std::copy(buffer_.begin() + begin_, buffer_.begin() + end_,
+      buffer_.begin());
+  }
+  begin_ = 0;
+  end_ = left;
+  if (end_ == buffer_.size()) {
+    buffer_.resize(buffer_.size() * 2);
+  }
+  size_t read = std::fread(
+    buffer_.data() + end_, 1, buffer_.size() - end_, file_);
+  end_ += read;
+  if (read == 0) {
+    eof_ = true;
+  }
+  return true;
+}
+
+void filter(
+  StandardVector& destination,
+  const StandardVector& batch,
+  ::gos::analysis::window& window,
+  const double& sdthreshold) {
+  for (auto v : batch) {
+    window.add(v.Temperature);
+    if (window.sd() < sdthreshold) {
+      destination.push_back(v);
+    }
+  }
+}
+
+void filter(
+  StandardVector& destination,
+  reader& reader,
+  const size_t& windowsize,
+  const double& sdthreshold) {
+  ga::window window(windowsize);
+  StandardVector batch;
+  while (reader.next(batch)) {
+    filter(destination, batch, window, sdthreshold);
   }
 }
 
@@ -66,6 +405,336 @@ void filter(
   }
 }
 
+void filter(
+  StandardVector& destination,
+  const StandardVector& source,
+  const size_t& windowsize,
+  const double& threshold,
+  const Criterion& criterion) {
+  switch (criterion) {
+  case Criterion::StandardDeviation:
+    filter(destination, source, windowsize, threshold);
+    break;
+  case Criterion::MedianAbsoluteDeviation: {
+    ga::quantile quantile(windowsize);
+    for (auto v : source) {
+      quantile.add(v.Temperature);
+      if (quantile.count() > 0 && quantile.mad() < threshold) {
+        destination.push_back(v);
+      }
+    }
+    break;
+  }
+  case Criterion::PeakToPeak: {
+    ga::window window(windowsize);
+    for (auto v : source) {
+      window.add(v.Temperature);
+      if (window.count() > 0 && window.peaktopeak() < threshold) {
+        destination.push_back(v);
+      }
+    }
+    break;
+  }
+  }
+}
+
+void filter(
+  StandardFrame& destination,
+  const StandardFrame& source,
+  const size_t& windowsize,
+  const double& sdthreshold) {
+  const size_t size = source.size();
+  const double* temperature = source.Temperature.data();
+  std::vector<size_t> selected;
+  ga::window window(windowsize);
+  for (size_t i = 0; i < size; i++) {
+    window.add(temperature[i]);
+    if (window.sd() < sdthreshold) {
+      selected.push_back(i);
+    }
+  }
+  size_t offset = destination.size();
+  destination.resize(offset + selected.size());
+  const StandardFrame::Column* columns[] = {
+    &source.Time, &source.Control, &source.Temperature };
+  StandardFrame::Column* targets[] = {
+    &destination.Time, &destination.Control, &destination.Temperature };
+  for (size_t c = 0; c < 3; c++) {
+    const double* from = columns[c]->data();
+    double* to = targets[c]->data() + offset;
+    for (size_t i = 0; i < selected.size(); i++) {
+      to[i] = from[selected[i]];
+    }
+  }
+}
+
+void filter(
+  CompactVector& destination,
+  const CompactVector& source,
+  const size_t& windowsize,
+  const double& sdthreshold) {
+  if (windowsize == 0) {
+    return;
+  }
+  std::vector<std::int32_t> ring(windowsize);
+  std::int64_t sum = 0, squares = 0;
+  size_t head = 0, count = 0;
+  /* Compare the variance in squared steps. With sum = q n + r the sum of
+     (x - q)^2 = squares - n q^2 - 2 q r stays exact in 64 bits, where
+     n squares - sum^2 overflows past about 9e4 rows */
+  const double limit = sdthreshold * Compact::StepsPerDegree;
+  for (const Compact& row : source) {
+    std::int32_t value = row.Temperature;
+    if (count < windowsize) {
+      count++;
+    } else {
+      sum -= ring[head];
+      squares -= static_cast<std::int64_t>(ring[head]) * ring[head];
+    }
+    ring[head] = value;
+    if (++head == windowsize) {
+      head = 0;
+    }
+    sum += value;
+    squares += static_cast<std::int64_t>(value) * value;
+    std::int64_t n = static_cast<std::int64_t>(count);
+    std::int64_t q = sum / n, r = sum % n;
+    double centered = static_cast<double>(squares - n * q * q - 2 * q * r);
+    double variance = (centered -
+      static_cast<double>(r) * static_cast<double>(r) /
+      static_cast<double>(n)) / static_cast<double>(n);
+    if (::sqrt(variance) < limit) {
+      destination.push_back(row);
+    }
+  }
+}
+
+void filter(
+  StandardVector& destination,
+  const StandardVector& source,
+  const ::gos::analysis::exponential& exponential,
+  const double& sdthreshold) {
+  ga::exponential accumulator(exponential);
+  accumulator.clear();
+  for (auto v : source) {
+    accumulator.add(v.Temperature, v.Time);
+    if (accumulator.sd() < sdthreshold) {
+      destination.push_back(v);
+    }
+  }
+}
+
+void filterspan(
+  StandardVector& destination,
+  const StandardVector& source,
+  const double& span,
+  const double& sdthreshold) {
+  ga::duration window(span);
+  for (auto v : source) {
+    window.add(v.Temperature, v.Time);
+    if (window.sd() < sdthreshold) {
+      destination.push_back(v);
+    }
+  }
+}
+
+void correlate(
+  CorrelationVector& destination,
+  const StandardVector& source,
+  const size_t& windowsize,
+  const size_t& lag) {
+  ga::bivariate bivariate(windowsize);
+  if (source.size() > lag) {
+    destination.reserve(destination.size() + source.size() - lag);
+  }
+  for (size_t i = lag; i < source.size(); i++) {
+    bivariate.add(source[i - lag].Control, source[i].Temperature);
+    destination.push_back(Correlation{
+      source[i].Time,
+      bivariate.covariance(),
+      bivariate.correlation() });
+  }
+}
+
+namespace detail {
+
+Compact compact(const Standard& standard) {
+  if (!fits(standard)) {
+    throw ga::exception("The row does not fit the compact representation");
+  }
+  Compact result;
+  result.Time = static_cast<std::uint32_t>(
+    ::round(standard.Time * Compact::TicksPerSecond));
+  result.Temperature = static_cast<std::int16_t>(
+    ::round(standard.Temperature * Compact::StepsPerDegree));
+  result.Control = static_cast<std::uint8_t>(standard.Control);
+  result.Reserved = 0;
+  return result;
+}
+
+void stream(StandardVector& vector, const char* filepath) {
+  ::io::CSVReader<3> csvreader(filepath);
+  csvreader.read_header(
+    io::ignore_extra_column,
+    "time",
+    "control",
+    "temperature");
+  double time, control, temperature;
+  while (csvreader.read_row(time, control, temperature)) {
+    vector.push_back(Standard(time, control, temperature));
+  }
+}
+
+/* Append the rows from the binary cache when it is valid, otherwise parse
+   the text and write the cache, a cache that cannot be written is not an
+   error */
+void cached(StandardFrame& frame, const char* filepath) {
+  if (frame.empty()) {
+    if (!ga::tc::binary::load(frame, filepath)) {
+      detail::mapped(frame, filepath, Parser::Mapped);
+      ga::tc::binary::save(frame, filepath);
+    }
+    return;
+  }
+  StandardFrame rows;
+  cached(rows, filepath);
+  frame.reserve(frame.size() + rows.size());
+  for (size_t i = 0; i < rows.size(); i++) {
+    frame.push_back(rows.row(i));
+  }
+}
+
+void roles(Roles& roles, const char* first, const char* last) {
+  static const char* names[] = { "time", "control", "temperature" };
+  ga::text::StringVector fields;
+  ga::text::split(fields, first, ga::text::end(first, last));
+  roles.clear();
+  for (int role = 0; role < 3; role++) {
+    int index = ga::text::find(fields, names[role]);
+    if (index < 0) {
+      std::string what("Missing the column ");
+      what += names[role];
+      throw ga::exception(what.c_str());
+    }
+    if (static_cast<size_t>(index) >= roles.size()) {
+      roles.resize(static_cast<size_t>(index) + 1, -1);
+    }
+    roles[index] = role;
+  }
+}
+
+template<typename Destination> void mapped(
+  Destination& destination,
+  const char* filepath,
+  const Parser& parser) {
+  ga::mapping mapping(filepath);
+  const char* first = mapping.begin();
+  const char* last = mapping.end();
+  const char* header = ga::text::next(first, last);
+  Roles roles;
+  detail::roles(roles, first, header);
+  if (parser == Parser::Parallel) {
+    parallel(destination, header, last, roles, ga::pool::shared());
+  } else {
+    /* One row per line feed and the last line may not have one */
+    destination.reserve(
+      destination.size() + ga::text::lines(header, last) + 1);
+    rows(destination, header, last, roles);
+  }
+}
+
+/* Parse rows from cursor until last or until limit rows have been parsed,
+   cursor is left at the start of the first line not parsed */
+template<typename Destination> size_t rows(
+  Destination& destination,
+  const char*& cursor,
+  const char* last,
+  const Roles& roles,
+  const size_t& limit) {
+  size_t count = 0;
+  size_t columns = roles.size();
+  double values[3];
+  while (cursor < last && count < limit) {
+    const char* lineend = ga::text::end(cursor, last);
+    const char* field = cursor;
+    cursor = lineend < last ? ga::text::next(lineend, last) : last;
+    if (field == lineend) {
+      continue;
+    }
+    for (size_t i = 0; i < columns; i++) {
+      int role = roles[i];
+      if (role >= 0 && !ga::text::number(field, lineend, values[role])) {
+        throw ga::exception("Invalid number in the standard file");
+      }
+      if (i + 1 < columns && !ga::text::skip(field, lineend)) {
+        throw ga::exception("Missing a column in the standard file");
+      }
+    }
+    destination.emplace_back(values[0], values[1], values[2]);
+    count++;
+  }
+  return count;
+}
+
+/* Split the text into chunks at line boundaries, parse the chunks on the
+   pool and stitch them together in order, so the result is the same as
+   the serial parse */
+template<typename Destination> void parallel(
+  Destination& destination,
+  const char* first,
+  const char* last,
+  const Roles& roles,
+  ::gos::analysis::pool& pool) {
+  const size_t minimum = 1 << 20;
+  size_t length = static_cast<size_t>(last - first);
+  size_t count = std::min(pool.size() * 4, length / minimum + 1);
+  std::vector<const char*> boundaries;
+  boundaries.push_back(first);
+  for (size_t i = 1; i < count; i++) {
+    const char* boundary = first + length / count * i;
+    if (boundary > boundaries.back()) {
+      boundaries.push_back(ga::text::next(boundary, last));
+    }
+  }
+  boundaries.push_back(last);
+  count = boundaries.size() - 1;
+  std::vector<Destination> chunks(count);
+  pool.run(count, [&](size_t i) {
+    chunks[i].reserve(ga::text::lines(boundaries[i], boundaries[i + 1]) + 1);
+    const char* cursor = boundaries[i];
+    rows(chunks[i], cursor, boundaries[i + 1], roles);
+  });
+  std::vector<size_t> offsets(count + 1, destination.size());
+  for (size_t i = 0; i < count; i++) {
+    offsets[i + 1] = offsets[i] + chunks[i].size();
+  }
+  destination.resize(offsets[count]);
+  pool.run(count, [&](size_t i) {
+    place(destination, chunks[i], offsets[i]);
+  });
+}
+
+void place(
+  StandardVector& destination,
+  const StandardVector& source,
+  const size_t& offset) {
+  std::copy(source.begin(), source.end(), destination.begin() + offset);
+}
+
+void place(
+  StandardFrame& destination,
+  const StandardFrame& source,
+  const size_t& offset) {
+  std::copy(source.Time.begin(), source.Time.end(),
+    destination.Time.begin() + offset);
+  std::copy(source.Control.begin(), source.Control.end(),
+    destination.Control.begin() + offset);
+  std::copy(source.Temperature.begin(), source.Temperature.end(),
+    destination.Temperature.begin() + offset);
+}
+
+} // namespace detail
+
 } // namespace tc
 } // namespace analysis
 } // namespace gos
@@ -0,0 +1,503 @@
+#include <cstring>
+
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <system_error>
+#include <type_traits>
+#include <unordered_map>
+
+#include <gos/analysis/tdms.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+namespace gos {
+namespace analysis {
+namespace tdms {
+
+namespace detail {
+const ::std::uint32_t TocMetaData = 1 << 1;
+const ::std::uint32_t TocNewObjList = 1 << 2;
+const ::std::uint32_t TocRawData = 1 << 3;
+const ::std::uint32_t TocInterleavedData = 1 << 5;
+const ::std::uint32_t TocBigEndian = 1 << 6;
+const ::std::uint32_t TocDAQmxRawData = 1 << 7;
+const ::std::uint32_t NoRawData = 0xFFFFFFFF;
+const ::std::uint32_t SameRawData = 0x00000000;
+const ::std::uint32_t DAQmxFormatChanging = 0x00001269;
+const ::std::uint32_t DAQmxDigitalLine = 0x0000126A;
+const ::std::uint64_t LeadIn = 28;
+const ::std::uint64_t Incomplete = 0xFFFFFFFFFFFFFFFFULL;
+/* Bounds checked little endian reader of the metadata */
+struct Cursor {
+  template<typename T> T read();
+  ::std::string string();
+  void skip(const ::std::uint64_t& count);
+  const char* First;
+  const char* Last;
+};
+/* An object with raw data in the current segment */
+struct Object {
+  size_t Channel;
+  Type DataType;
+  ::std::uint64_t Count;
+  ::std::uint64_t Bytes;
+};
+typedef ::std::vector<Object> ObjectVector;
+static ::std::uint64_t size(const Type& type);
+static bool split(
+  const ::std::string& path,
+  ::std::string& group,
+  ::std::string& name);
+static void property(Cursor& cursor);
+static void append(Channel& channel, const Chunk& chunk);
+static bool little();
+template<typename T> static void convert(
+  type::AlignedDoubleVector& column,
+  const char* data,
+  const Chunk& chunk);
+} // namespace detail
+
+file::file(const char* filepath) : mapping_(filepath) {
+  std::string indexpath(filepath);
+  indexpath += "_index";
+  std::error_code error;
+  std::unique_ptr<ga::mapping> index;
+  if (std::filesystem::is_regular_file(indexpath, error)) {
+    index.reset(new ga::mapping(indexpath.c_str()));
+  }
+  const char* tag = index ? "TDSh" : "TDSm";
+  const char* first = index ? index->begin() : mapping_.begin();
+  const char* last = index ? index->end() : mapping_.end();
+  const std::uint64_t filesize = mapping_.size();
+  std::unordered_map<std::string, size_t> paths;
+  detail::ObjectVector previous;
+  detail::ObjectVector objects;
+  std::uint64_t position = 0;
+  while (first < last && position < filesize) {
+    detail::Cursor cursor = { first, last };
+    if (static_cast<std::uint64_t>(last - first) < detail::LeadIn ||
+      std::memcmp(first, tag, 4) != 0 ||
+      filesize - position < detail::LeadIn ||
+      std::memcmp(mapping_.data() + position, "TDSm", 4) != 0) {
+      throw ga::exception("Invalid TDMS segment lead-in");
+    }
+    cursor.skip(4);
+    std::uint32_t toc = cursor.read<std::uint32_t>();
+    cursor.read<std::uint32_t>();
+    std::uint64_t next = cursor.read<std::uint64_t>();
+    std::uint64_t raw = cursor.read<std::uint64_t>();
+    if (toc & detail::TocDAQmxRawData) {
+      throw ga::exception("TDMS DAQmx raw data is not supported");
+    }
+    std::uint64_t data = position + detail::LeadIn + raw;
+    std::uint64_t end = next == detail::Incomplete ||
+      next > filesize - position - detail::LeadIn ?
+      filesize : position + detail::LeadIn + next;
+    if (raw > static_cast<std::uint64_t>(last - cursor.First) || data > end) {
+      throw ga::exception("Invalid TDMS segment lead-in");
+    }
+    if (toc & detail::TocMetaData) {
+      detail::Cursor metadata = { cursor.First, cursor.First + raw };
+      if (toc & detail::TocNewObjList) {
+        objects.clear();
+      }
+      std::uint32_t count = metadata.read<std::uint32_t>();
+      for (std::uint32_t i = 0; i < count; i++) {
+        std::string path = metadata.string();
+        std::uint32_t rawindex = metadata.read<std::uint32_t>();
+        std::string group, name;
+        bool channel = detail::split(path, group, name);
+        if (rawindex != detail::NoRawData && !channel) {
+          throw ga::exception("TDMS raw data for an object not a channel");
+        }
+        size_t number = 0;
+        if (channel) {
+          auto found = paths.find(path);
+          if (found == paths.end()) {
+            number = channels_.size();
+            paths.emplace(path, number);
+            channels_.push_back(
+              Channel{ group, name, Type::Void, 0, ChunkVector() });
+            previous.push_back(detail::Object{ number, Type::Void, 0, 0 });
+          } else {
+            number = found->second;
+          }
+        }
+        auto active = std::find_if(objects.begin(), objects.end(),
+          [number](const detail::Object& object) {
+            return object.Channel == number;
+          });
+        if (rawindex == detail::NoRawData) {
+          if (channel && active != objects.end()) {
+            objects.erase(active);
+          }
+        } else {
+          detail::Object object = previous[number];
+          if (rawindex != detail::SameRawData) {
+            if (rawindex == detail::DAQmxFormatChanging ||
+              rawindex == detail::DAQmxDigitalLine ||
+              rawindex < 20) {
+              throw ga::exception("TDMS raw data index is not supported");
+            }
+            object.DataType = static_cast<Type>(
+              metadata.read<std::uint32_t>());
+            if (metadata.read<std::uint32_t>() != 1) {
+              throw ga::exception("TDMS array dimension must be 1");
+            }
+            object.Count = metadata.read<std::uint64_t>();
+            if (object.DataType == Type::String) {
+              object.Bytes = metadata.read<std::uint64_t>();
+              metadata.skip(rawindex - 28);
+            } else {
+              object.Bytes = object.Count * detail::size(object.DataType);
+              metadata.skip(rawindex - 20);
+            }
+            if (object.Bytes == 0 && object.Count > 0) {
+              throw ga::exception("TDMS data type is not supported");
+            }
+            previous[number] = object;
+          }
+          if (object.DataType == Type::Void) {
+            throw ga::exception("TDMS raw data index refers to no index");
+          }
+          if (channels_[number].DataType == Type::Void) {
+            channels_[number].DataType = object.DataType;
+          } else if (channels_[number].DataType != object.DataType) {
+            throw ga::exception("TDMS channel changes data type");
+          }
+          if (active != objects.end()) {
+            *active = object;
+          } else {
+            objects.push_back(object);
+          }
+        }
+        std::uint32_t properties = metadata.read<std::uint32_t>();
+        for (std::uint32_t p = 0; p < properties; p++) {
+          detail::property(metadata);
+        }
+      }
+    }
+    if ((toc & detail::TocRawData) && !objects.empty()) {
+      std::uint64_t chunksize = 0;
+      for (const detail::Object& object : objects) {
+        chunksize += object.Bytes;
+      }
+      std::uint64_t chunks = chunksize > 0 ? (end - data) / chunksize : 0;
+      bool bigendian = (toc & detail::TocBigEndian) != 0;
+      std::uint64_t offset = data;
+      if (toc & detail::TocInterleavedData) {
+        /* One value of every channel after the other, the counts of the
+           channels are the same */
+        std::uint64_t row = 0;
+        for (const detail::Object& object : objects) {
+          row += detail::size(object.DataType);
+          if (object.Count != objects.front().Count) {
+            throw ga::exception("TDMS interleaved counts must be the same");
+          }
+        }
+        for (const detail::Object& object : objects) {
+          std::uint64_t bytes = detail::size(object.DataType);
+          if (bytes == 0) {
+            throw ga::exception("TDMS interleaved data must be fixed size");
+          }
+          detail::append(channels_[object.Channel], Chunk{
+            offset, object.Count * chunks, row, 1, 0, bigendian });
+          offset += bytes;
+        }
+      } else {
+        for (const detail::Object& object : objects) {
+          detail::append(channels_[object.Channel], Chunk{
+            offset, object.Count, detail::size(object.DataType), chunks,
+            chunksize, bigendian });
+          offset += object.Bytes;
+        }
+      }
+    }
+    if (next == detail::Incomplete) {
+      break;
+    }
+    first = cursor.First + (index ? raw : next);
+    position = end;
+  }
+}
+
+const ChannelVector& file::channels() const {
+  return channels_;
+}
+
+int file::find(const char* group, const char* name) const {
+  for (size_t i = 0; i < channels_.size(); i++) {
+    if (channels_[i].Group == group && channels_[i].Name == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+int file::find(const char* name) const {
+  for (size_t i = 0; i < channels_.size(); i++) {
+    if (channels_[i].Name == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+const double* file::view(const size_t& channel) const {
+  const Channel& found = channels_.at(channel);
+  if ((found.DataType != Type::Double &&
+    found.DataType != Type::DoubleWithUnit) ||
+    found.Chunks.size() != 1) {
+    return nullptr;
+  }
+  const Chunk& chunk = found.Chunks.front();
+  const char* data = mapping_.data() + chunk.Offset;
+  if (chunk.Repeat != 1 ||
+    chunk.Stride != sizeof(double) ||
+    chunk.BigEndian != !detail::little() ||
+    reinterpret_cast<std::uintptr_t>(data) % alignof(double) != 0) {
+    return nullptr;
+  }
+  return reinterpret_cast<const double*>(data);
+}
+
+void file::read(
+  type::AlignedDoubleVector& column,
+  const size_t& channel) const {
+  const Channel& found = channels_.at(channel);
+  column.reserve(column.size() + static_cast<size_t>(found.Count));
+  const char* data = mapping_.data();
+  for (const Chunk& chunk : found.Chunks) {
+    switch (found.DataType) {
+    case Type::Int8:
+      detail::convert<std::int8_t>(column, data, chunk);
+      break;
+    case Type::Int16:
+      detail::convert<std::int16_t>(column, data, chunk);
+      break;
+    case Type::Int32:
+      detail::convert<std::int32_t>(column, data, chunk);
+      break;
+    case Type::Int64:
+      detail::convert<std::int64_t>(column, data, chunk);
+      break;
+    case Type::UInt8:
+    case Type::Boolean:
+      detail::convert<std::uint8_t>(column, data, chunk);
+      break;
+    case Type::UInt16:
+      detail::convert<std::uint16_t>(column, data, chunk);
+      break;
+    case Type::UInt32:
+      detail::convert<std::uint32_t>(column, data, chunk);
+      break;
+    case Type::UInt64:
+      detail::convert<std::uint64_t>(column, data, chunk);
+      break;
+    case Type::Single:
+    case Type::SingleWithUnit:
+      detail::convert<float>(column, data, chunk);
+      break;
+    case Type::Double:
+    case Type::DoubleWithUnit:
+      detail::convert<double>(column, data, chunk);
+      break;
+    default:
+      throw ga::exception("TDMS channel is not numeric");
+    }
+  }
+}
+
+void read(ga::tc::StandardFrame& frame, const file& file) {
+  const char* names[] = { "time", "control", "temperature" };
+  ga::tc::StandardFrame::Column* columns[] = {
+    &frame.Time, &frame.Control, &frame.Temperature };
+  int channels[3];
+  for (size_t i = 0; i < 3; i++) {
+    channels[i] = file.find(names[i]);
+    if (channels[i] < 0) {
+      std::string what("Missing the channel ");
+      what += names[i];
+      throw ga::exception(what.c_str());
+    }
+  }
+  size_t offset = frame.size();
+  for (size_t i = 0; i < 3; i++) {
+    file.read(*columns[i], static_cast<size_t>(channels[i]));
+  }
+  /* A channel written after the others stopped is cut to the rows all of
+     them have */
+  size_t size = std::min(std::min(frame.Time.size(), frame.Control.size()),
+    frame.Temperature.size());
+  frame.resize(std::max(size, offset));
+}
+
+namespace detail {
+
+template<typename T> T Cursor::read() {
+  if (static_cast<size_t>(Last - First) < sizeof(T)) {
+    throw ga::exception("Truncated TDMS metadata");
+  }
+  T value;
+  std::memcpy(&value, First, sizeof(T));
+  First += sizeof(T);
+  return value;
+}
+
+std::string Cursor::string() {
+  std::uint32_t length = read<std::uint32_t>();
+  const char* first = First;
+  skip(length);
+  return std::string(first, length);
+}
+
+void Cursor::skip(const std::uint64_t& count) {
+  if (static_cast<std::uint64_t>(Last - First) < count) {
+    throw ga::exception("Truncated TDMS metadata");
+  }
+  First += count;
+}
+
+std::uint64_t size(const Type& type) {
+  switch (type) {
+  case Type::Int8:
+  case Type::UInt8:
+  case Type::Boolean:
+    return 1;
+  case Type::Int16:
+  case Type::UInt16:
+    return 2;
+  case Type::Int32:
+  case Type::UInt32:
+  case Type::Single:
+  case Type::SingleWithUnit:
+    return 4;
+  case Type::Int64:
+  case Type::UInt64:
+  case Type::Double:
+  case Type::DoubleWithUnit:
+    return 8;
+  case Type::Timestamp:
+    return 16;
+  default:
+    return 0;
+  }
+}
+
+/* Split a channel path /'group'/'name' where a quote in a name is
+   doubled, false for the root and for a group */
+bool split(const std::string& path, std::string& group, std::string& name) {
+  std::string* parts[] = { &group, &name };
+  size_t count = 0;
+  size_t i = path == "/" ? 1 : 0;
+  while (i < path.size()) {
+    if (path[i] != '/' || i + 1 >= path.size() || path[i + 1] != '\'' ||
+      count == 2) {
+      throw ga::exception("Invalid TDMS object path");
+    }
+    std::string& part = *parts[count++];
+    part.clear();
+    for (i += 2; ; i++) {
+      if (i >= path.size()) {
+        throw ga::exception("Invalid TDMS object path");
+      }
+      if (path[i] == '\'') {
+        if (i + 1 < path.size() && path[i + 1] == '\'') {
+          part += '\'';
+          i++;
+        } else {
+          i++;
+          break;
+        }
+      } else {
+        part += path[i];
+      }
+    }
+  }
+  return count == 2;
+}
+
+void property(Cursor& cursor) {
+  cursor.string();
+  Type type = static_cast<Type>(cursor.read<std::uint32_t>());
+  if (type == Type::String) {
+    cursor.string();
+  } else {
+    std::uint64_t bytes = size(type);
+    if (bytes == 0) {
+      throw ga::exception("TDMS property type is not supported");
+    }
+    cursor.skip(bytes);
+  }
+}
+
+/* Append the chunk to the channel, merged with the chunk before when the
+   values continue where those end */
+void append(Channel& channel, const Chunk& chunk) {
+  if (chunk.Count == 0 || chunk.Repeat == 0) {
+    return;
+  }
+  Chunk added(chunk);
+  if (added.Repeat > 1 && added.Step == added.Count * added.Stride) {
+    added.Count *= added.Repeat;
+    added.Repeat = 1;
+    added.Step = 0;
+  }
+  channel.Count += added.Count * added.Repeat;
+  if (!channel.Chunks.empty()) {
+    Chunk& back = channel.Chunks.back();
+    if (back.Repeat == 1 && added.Repeat == 1 &&
+      back.Stride == added.Stride &&
+      back.BigEndian == added.BigEndian &&
+      back.Offset + back.Count * back.Stride == added.Offset) {
+      back.Count += added.Count;
+      return;
+    }
+  }
+  channel.Chunks.push_back(added);
+}
+
+bool little() {
+  const std::uint16_t one = 1;
+  unsigned char first;
+  std::memcpy(&first, &one, 1);
+  return first == 1;
+}
+
+template<typename T> void convert(
+  type::AlignedDoubleVector& column,
+  const char* data,
+  const Chunk& chunk) {
+  bool swap = chunk.BigEndian == little();
+  size_t offset = column.size();
+  column.resize(offset + static_cast<size_t>(chunk.Count * chunk.Repeat));
+  double* target = column.data() + offset;
+  for (std::uint64_t r = 0; r < chunk.Repeat; r++) {
+    const char* source = data + chunk.Offset + r * chunk.Step;
+    if (!swap && chunk.Stride == sizeof(T) &&
+      std::is_same<T, double>::value) {
+      std::memcpy(target, source, static_cast<size_t>(chunk.Count) * sizeof(T));
+      target += chunk.Count;
+      continue;
+    }
+    for (std::uint64_t i = 0; i < chunk.Count; i++) {
+      unsigned char bytes[sizeof(T)];
+      std::memcpy(bytes, source + i * chunk.Stride, sizeof(T));
+      if (swap) {
+        std::reverse(bytes, bytes + sizeof(T));
+      }
+      T value;
+      std::memcpy(&value, bytes, sizeof(T));
+      *target++ = static_cast<double>(value);
+    }
+  }
+}
+
+} // namespace detail
+
+} // namespace tdms
+} // namespace analysis
+} // namespace gos
@@ -0,0 +1,178 @@
+#include <cstring>
+
+#include <charconv>
+
+#include <gos/analysis/text.h>
+
+namespace gos {
+namespace analysis {
+namespace text {
+
+namespace detail {
+static bool delimited(
+  const char*& cursor,
+  const char* last,
+  const char& delimiter);
+} // namespace detail
+
+size_t lines(const char* first, const char* last) {
+  size_t count = 0;
+  const char* cursor = first;
+  while (cursor < last) {
+    const void* found = ::memchr(cursor, '\n', last - cursor);
+    if (found == nullptr) {
+      break;
+    }
+    cursor = static_cast<const char*>(found) + 1;
+    count++;
+  }
+  return count;
+}
+
+const char* next(const char* first, const char* last) {
+  const void* found = ::memchr(first, '\n', last - first);
+  return found == nullptr ? last : static_cast<const char*>(found) + 1;
+}
+
+const char* end(const char* first, const char* last) {
+  const void* found = ::memchr(first, '\n', last - first);
+  const char* result = found == nullptr ?
+    last : static_cast<const char*>(found);
+  if (result > first && *(result - 1) == '\r') {
+    result--;
+  }
+  return result;
+}
+
+void split(
+  StringVector& fields,
+  const char* first,
+  const char* last,
+  const char& delimiter) {
+  fields.clear();
+  const char* cursor = first;
+  for (;;) {
+    const char* field = cursor;
+    while (cursor < last && *cursor != delimiter) {
+      cursor++;
+    }
+    const char* fieldend = cursor;
+    while (field < fieldend && (*field == ' ' || *field == '\t')) {
+      field++;
+    }
+    while (fieldend > field &&
+      (*(fieldend - 1) == ' ' || *(fieldend - 1) == '\t')) {
+      fieldend--;
+    }
+    fields.push_back(std::string(field, fieldend));
+    if (cursor >= last) {
+      break;
+    }
+    cursor++;
+  }
+}
+
+int find(const StringVector& fields, const char* name) {
+  for (size_t i = 0; i < fields.size(); i++) {
+    if (fields[i] == name) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+bool number(
+  const char*& cursor,
+  const char* last,
+  double& value,
+  const char& delimiter) {
+  static const double powers[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+  const char* first = cursor;
+  while (first < last && *first == ' ') {
+    first++;
+  }
+  /* std::from_chars does not accept a leading plus sign */
+  if (first < last && *first == '+') {
+    first++;
+    if (first < last && (*first == '+' || *first == '-')) {
+      return false;
+    }
+  }
+  /* Fast path for plain decimals, when the digits fit in the mantissa
+     mantissa / 10^fraction is exact before the one correctly rounded
+     division so the result is the same as std::from_chars */
+  const char* digit = first;
+  bool negative = digit < last && *digit == '-';
+  if (negative) {
+    digit++;
+  }
+  unsigned long long mantissa = 0;
+  int digits = 0;
+  int fraction = 0;
+  const char* start = digit;
+  while (digit < last && *digit >= '0' && *digit <= '9') {
+    mantissa = mantissa * 10 + static_cast<unsigned>(*digit - '0');
+    digits++;
+    digit++;
+  }
+  if (digit < last && *digit == '.') {
+    digit++;
+    while (digit < last && *digit >= '0' && *digit <= '9') {
+      mantissa = mantissa * 10 + static_cast<unsigned>(*digit - '0');
+      digits++;
+      fraction++;
+      digit++;
+    }
+  }
+  if (digits > 0 && digits <= 15 &&
+    (digit >= last || (*digit != 'e' && *digit != 'E')) &&
+    digit - start > (fraction > 0 ? 1 : 0)) {
+    if (!detail::delimited(digit, last, delimiter)) {
+      return false;
+    }
+    value = static_cast<double>(mantissa) / powers[fraction];
+    if (negative) {
+      value = -value;
+    }
+    cursor = digit;
+    return true;
+  }
+  double parsed;
+  std::from_chars_result result = std::from_chars(first, last, parsed);
+  const char* after = result.ptr;
+  if (result.ec != std::errc() || !detail::delimited(after, last, delimiter)) {
+    return false;
+  }
+  value = parsed;
+  cursor = after;
+  return true;
+}
+
+bool skip(const char*& cursor, const char* last, const char& delimiter) {
+  while (cursor < last && *cursor != delimiter && *cursor != '\n') {
+    cursor++;
+  }
+  if (cursor < last && *cursor == delimiter) {
+    cursor++;
+    return true;
+  }
+  return false;
+}
+
+namespace detail {
+
+/* Skip the blanks at cursor, true if the field ends there */
+bool delimited(const char*& cursor, const char* last, const char& delimiter) {
+  while (cursor < last && (*cursor == ' ' || *cursor == '\t')) {
+    cursor++;
+  }
+  return cursor >= last || *cursor == delimiter;
+}
+
+} // namespace detail
+
+} // namespace text
+} // namespace analysis
+} // namespace gos
@@ -1,6 +1,7 @@
 #include <cmath>
 
 #include <algorithm>
+#include <limits>
 
 #include <gos/analysis/window.h>
 
@@ -9,31 +10,224 @@ namespace ga = ::gos::analysis;
 namespace gos {
 namespace analysis {
 
-window::window() : size_(10), sum_(0.0) {
+window::window() :
+  ordered_(true),
+  policy_(RangePolicy::Reject),
+  outliers_(0),
+  size_(10),
+  head_(0),
+  count_(0),
+  sum_(0.0),
+  mean_(0.0),
+  m2_(0.0),
+  replacements_(0),
+  tracking_(false),
+  extremes_(false),
+  sequence_(0) {
 }
 
-window::window(const size_t& size) : size_(size), sum_(0.0) {
+window::window(const size_t& size) :
+  ordered_(true),
+  policy_(RangePolicy::Reject),
+  outliers_(0),
+  size_(size),
+  head_(0),
+  count_(0),
+  sum_(0.0),
+  mean_(0.0),
+  m2_(0.0),
+  replacements_(0),
+  tracking_(false),
+  extremes_(false),
+  sequence_(0) {
 }
 
-void window::setrange(const double& lowest, const double& highest) {
+namespace detail {
+/* The batch kernels keep four independent partial results, which lets the
+   compiler use SIMD for them without reordering floating point additions */
+static double accumulate(const double* values, const size_t& count);
+static double squares(const double* values, const size_t& count, double mean);
+static size_t outside(
+  const double* values,
+  const size_t& count,
+  const double& lowest,
+  const double& highest);
+static void clamp(
+  double* destination,
+  const double* values,
+  const size_t& count,
+  const double& lowest,
+  const double& highest);
+static size_t inside(
+  double* destination,
+  const double* values,
+  const size_t& count,
+  const double& lowest,
+  const double& highest);
+static size_t missing(const double* values, const size_t& count);
+} // namespace detail
+
+void window::setrange(
+  const double& lowest,
+  const double& highest,
+  const RangePolicy& policy) {
   range_ = std::make_unique<ga::type::Range>(lowest, highest);
+  policy_ = policy;
+}
+
+bool window::add(const double& value) {
+  if (this->range_) {
+    const double& lowest = this->range_->first;
+    const double& highest = this->range_->second;
+    /* NaN is outside of any range */
+    if (!(value >= lowest && value <= highest)) {
+      this->outliers_++;
+      switch (this->policy_) {
+      case RangePolicy::Reject:
+        return false;
+      case RangePolicy::Clamp:
+        if (std::isnan(value)) {
+          return false;
+        }
+        this->push(value < lowest ? lowest : highest);
+        return true;
+      case RangePolicy::Outlier:
+        break;
+      }
+    }
+  }
+  if (std::isnan(value)) {
+    return false;
+  }
+  this->push(value);
+  return true;
 }
 
-void window::add(const double& value) {
-  if (this->vector_.size() >= this->size_) {
-    this->sum_ -= *(this->vector_.begin());
-    this->vector_.erase(this->vector_.begin());
+size_t window::add(const double* first, const size_t& count) {
+  const double* values = first;
+  size_t accepted = count;
+  double lowest = -std::numeric_limits<double>::infinity();
+  double highest = std::numeric_limits<double>::infinity();
+  size_t outliers = 0;
+  if (this->range_ && count > 0) {
+    outliers = detail::outside(
+      first, count, this->range_->first, this->range_->second);
+    this->outliers_ += outliers;
+    if (outliers > 0 && this->policy_ == RangePolicy::Clamp) {
+      this->scratch_.resize(count);
+      detail::clamp(this->scratch_.data(), first, count,
+        this->range_->first, this->range_->second);
+      values = this->scratch_.data();
+    } else if (this->policy_ == RangePolicy::Reject) {
+      lowest = this->range_->first;
+      highest = this->range_->second;
+    }
+  }
+  /* Drop the rejected values and NaN, in place when clamped */
+  bool reject = outliers > 0 && this->policy_ == RangePolicy::Reject;
+  if (reject || detail::missing(values, count) > 0) {
+    this->scratch_.resize(count);
+    accepted = detail::inside(
+      this->scratch_.data(), values, count, lowest, highest);
+    values = this->scratch_.data();
+  }
+  /* Small batches compared with the window are cheaper one by one */
+  if (accepted < this->size_ / 4) {
+    for (size_t i = 0; i < accepted; i++) {
+      this->push(values[i]);
+    }
+  } else {
+    this->bulk(values, accepted);
+  }
+  return accepted;
+}
+
+const size_t& window::outliers() const {
+  return outliers_;
+}
+
+void window::push(const double& value) {
+  if (this->size_ == 0) {
+    return;
+  }
+  if (this->buffer_.size() != this->size_) {
+    this->buffer_.resize(this->size_);
+  }
+  if (this->count_ < this->size_) {
+    size_t position = this->head_ + this->count_;
+    if (position >= this->size_) {
+      position -= this->size_;
+    }
+    this->buffer_[position] = value;
+    this->count_++;
+    this->sum_ += value;
+    double delta = value - this->mean_;
+    this->mean_ += delta / static_cast<double>(this->count_);
+    this->m2_ += delta * (value - this->mean_);
+    if (this->tracking_) {
+      this->order_.insert(value);
+    }
+  } else {
+    double evicted = this->buffer_[this->head_];
+    if (this->tracking_) {
+      this->order_.erase(evicted);
+      this->order_.insert(value);
+    }
+    this->buffer_[this->head_] = value;
+    if (++(this->head_) >= this->size_) {
+      this->head_ = 0;
+    }
+    this->sum_ += value - evicted;
+    double mean = this->mean_;
+    this->mean_ += (value - evicted) / static_cast<double>(this->count_);
+    this->m2_ += (value - evicted) * (value - this->mean_ + evicted - mean);
+    /* Resynchronise once per window length to bound the rounding drift */
+    if (++(this->replacements_) >= this->size_) {
+      this->synchronize();
+    }
   }
-  this->vector_.push_back(value);
-  this->sum_ += value;
+  if (this->extremes_) {
+    size_t oldest = this->sequence_ + 1 - this->count_;
+    this->minimum_.evict(oldest);
+    this->minimum_.push(value, this->sequence_);
+    this->maximum_.evict(oldest);
+    this->maximum_.push(value, this->sequence_);
+  }
+  this->sequence_++;
+  this->ordered_ = false;
 }
 
 void window::clear() {
+  this->outliers_ = 0;
   this->sum_ = 0.0;
+  this->mean_ = 0.0;
+  this->m2_ = 0.0;
+  this->replacements_ = 0;
+  this->order_.clear();
+  this->tracking_ = false;
+  this->extremes_ = false;
+  this->head_ = 0;
+  this->count_ = 0;
   this->vector_.clear();
+  this->ordered_ = true;
 }
 
 void window::set(const size_t& size) {
+  if (size != this->size_) {
+    size_t count = std::min(this->count_, size);
+    ga::type::DoubleVector buffer(size);
+    for (size_t i = 0; i < count; i++) {
+      buffer[i] = this->at(this->count_ - count + i);
+    }
+    this->buffer_.swap(buffer);
+    this->head_ = 0;
+    this->count_ = count;
+    this->synchronize();
+    this->order_.clear();
+    this->tracking_ = false;
+    this->extremes_ = false;
+    this->ordered_ = false;
+  }
   this->size_ = size;
 }
 
@@ -42,10 +236,26 @@ const size_t& window::size() const {
 }
 
 size_t window::count() const {
-  return vector_.size();
+  return count_;
+}
+
+const double& window::at(const size_t& index) const {
+  size_t position = head_ + index;
+  if (position >= size_) {
+    position -= size_;
+  }
+  return buffer_[position];
 }
 
 const ::gos::analysis::type::DoubleVector& window::vector() const {
+  if (!ordered_) {
+    ga::type::DoubleVector::const_iterator begin = buffer_.begin();
+    ga::type::DoubleVector::const_iterator head = begin + head_;
+    size_t tail = std::min(count_, size_ - head_);
+    vector_.assign(head, head + tail);
+    vector_.insert(vector_.end(), begin, begin + (count_ - tail));
+    ordered_ = true;
+  }
   return vector_;
 }
 
@@ -54,41 +264,216 @@ const double& window::sum() const {
 }
 
 double window::mean() const {
-  return sum_ / static_cast<double>(vector_.size());
+  return mean_;
 }
 
-double window::median() {
-  ga::type::DoubleSize size = this->vector_.size();
+double window::median() const {
+  size_t size = this->count_;
   if (size > 1) {
+    this->track();
     size_t medianindex = size / 2;
-    ga::type::DoubleVector sorted(vector_);
-    std::sort(sorted.begin(), sorted.end());
     if (size % 2 == 0) {
-      return (sorted[medianindex - 1] + sorted[medianindex]) / 2.0;
+      return (this->order_.select(medianindex - 1) +
+        this->order_.select(medianindex)) / 2.0;
     } else {
-      return sorted[medianindex];
+      return this->order_.select(medianindex);
     }
   } else if(size == 1) {
-    return *(this->vector_.begin());
+    return this->at(0);
   } else {
     return 0.0;
   }
 }
 
 double window::variance() const {
-  double diff;
-  double variance = 0.0;
-  double mean = this->mean();
-  for (auto v : this->vector_) {
-    diff = v - mean;
-    variance += diff * diff;
-  }
-  return variance / this->vector_.size();
+  return std::max(m2_, 0.0) / static_cast<double>(count_);
 }
 
 double window::sd() const {
   return ::sqrt(variance());
 }
 
+double window::minimum() const {
+  if (count_ > 0) {
+    this->extremes();
+    return minimum_.front();
+  } else {
+    return 0.0;
+  }
+}
+
+double window::maximum() const {
+  if (count_ > 0) {
+    this->extremes();
+    return maximum_.front();
+  } else {
+    return 0.0;
+  }
+}
+
+double window::peaktopeak() const {
+  return maximum() - minimum();
+}
+
+/* Copy the batch into the buffer and recalculate the statistics from the
+   buffer, the order statistics and extremes are rebuilt when requested */
+void window::bulk(const double* first, const size_t& count) {
+  if (this->size_ == 0 || count == 0) {
+    return;
+  }
+  if (this->buffer_.size() != this->size_) {
+    this->buffer_.resize(this->size_);
+  }
+  if (count >= this->size_) {
+    std::copy(first + (count - this->size_), first + count,
+      this->buffer_.begin());
+    this->head_ = 0;
+    this->count_ = this->size_;
+  } else {
+    /* The values occupy the start of the buffer until it is full */
+    size_t fill = std::min(this->size_ - this->count_, count);
+    std::copy(first, first + fill, this->buffer_.begin() + this->count_);
+    this->count_ += fill;
+    size_t remaining = count - fill;
+    size_t tail = std::min(remaining, this->size_ - this->head_);
+    std::copy(first + fill, first + fill + tail,
+      this->buffer_.begin() + this->head_);
+    std::copy(first + fill + tail, first + count, this->buffer_.begin());
+    this->head_ += remaining;
+    if (this->head_ >= this->size_) {
+      this->head_ -= this->size_;
+    }
+  }
+  this->sequence_ += count;
+  this->synchronize();
+  this->order_.clear();
+  this->tracking_ = false;
+  this->extremes_ = false;
+  this->ordered_ = false;
+}
+
+void window::synchronize() {
+  /* Until the window has been filled the values occupy the start of the
+     buffer and once filled all of the buffer, order does not matter here */
+  const double* values = this->buffer_.data();
+  double sum = detail::accumulate(values, this->count_);
+  double mean = this->count_ > 0 ? sum / this->count_ : 0.0;
+  this->sum_ = sum;
+  this->mean_ = mean;
+  this->m2_ = detail::squares(values, this->count_, mean);
+  this->replacements_ = 0;
+}
+
+void window::track() const {
+  if (!this->tracking_) {
+    this->order_.clear();
+    this->order_.reserve(this->size_);
+    for (size_t i = 0; i < this->count_; i++) {
+      this->order_.insert(this->buffer_[i]);
+    }
+    this->tracking_ = true;
+  }
+}
+
+void window::extremes() const {
+  if (!this->extremes_) {
+    this->minimum_.set(this->size_);
+    this->maximum_.set(this->size_);
+    size_t oldest = this->sequence_ - this->count_;
+    for (size_t i = 0; i < this->count_; i++) {
+      this->minimum_.push(this->at(i), oldest + i);
+      this->maximum_.push(this->at(i), oldest + i);
+    }
+    this->extremes_ = true;
+  }
+}
+
+namespace detail {
+
+double accumulate(const double* values, const size_t& count) {
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    s0 += values[i];
+    s1 += values[i + 1];
+    s2 += values[i + 2];
+    s3 += values[i + 3];
+  }
+  for (; i < count; i++) {
+    s0 += values[i];
+  }
+  return (s0 + s1) + (s2 + s3);
+}
+
+double squares(const double* values, const size_t& count, double mean) {
+  double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    double d0 = values[i] - mean;
+    double d1 = values[i + 1] - mean;
+    double d2 = values[i + 2] - mean;
+    double d3 = values[i + 3] - mean;
+    s0 += d0 * d0;
+    s1 += d1 * d1;
+    s2 += d2 * d2;
+    s3 += d3 * d3;
+  }
+  for (; i < count; i++) {
+    double d = values[i] - mean;
+    s0 += d * d;
+  }
+  return (s0 + s1) + (s2 + s3);
+}
+
+size_t outside(
+  const double* values,
+  const size_t& count,
+  const double& lowest,
+  const double& highest) {
+  size_t result = 0;
+  for (size_t i = 0; i < count; i++) {
+    result += static_cast<size_t>(
+      !((values[i] >= lowest) & (values[i] <= highest)));
+  }
+  return result;
+}
+
+void clamp(
+  double* destination,
+  const double* values,
+  const size_t& count,
+  const double& lowest,
+  const double& highest) {
+  for (size_t i = 0; i < count; i++) {
+    double value = values[i];
+    value = value < lowest ? lowest : value;
+    destination[i] = value > highest ? highest : value;
+  }
+}
+
+size_t inside(
+  double* destination,
+  const double* values,
+  const size_t& count,
+  const double& lowest,
+  const double& highest) {
+  size_t result = 0;
+  for (size_t i = 0; i < count; i++) {
+    destination[result] = values[i];
+    result += static_cast<size_t>(values[i] >= lowest && values[i] <= highest);
+  }
+  return result;
+}
+
+size_t missing(const double* values, const size_t& count) {
+  size_t result = 0;
+  for (size_t i = 0; i < count; i++) {
+    result += static_cast<size_t>(values[i] != values[i]);
+  }
+  return result;
+}
+
+} // namespace detail
+
 } // namespace analysis
 } // namespace gos
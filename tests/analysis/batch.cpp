@@ -0,0 +1,58 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/tests/analysis.h>
+
+#include <gos/analysis/batch.h>
+#include <gos/analysis/tc.h>
+
+namespace ga = ::gos::analysis;
+namespace fs = ::std::filesystem;
+
+TEST(AnalysisBatchTest, Summarize) {
+  fs::path standard =
+    fs::path(GA_UNIT_TESTING_VAR_TC_STANDARD_PATH).parent_path();
+  std::vector<std::string> filepaths = {
+    (standard / "200410a.csv").string(),
+    (standard / "missing.csv").string(),
+    (standard / "191122.csv").string() };
+  ga::batch::Options options;
+  options.Limit = 1;
+  ga::batch::SummaryVector summaries;
+  ga::pool pool(3);
+
+  ga::batch::summarize(summaries, filepaths, options, pool);
+
+  ASSERT_EQ(3, summaries.size());
+  EXPECT_EQ(filepaths[0], summaries[0].File);
+  EXPECT_EQ(3937, summaries[0].Rows);
+  EXPECT_TRUE(summaries[0].Error.empty());
+  EXPECT_FALSE(summaries[1].Error.empty());
+  EXPECT_EQ(9399, summaries[2].Rows);
+  EXPECT_DOUBLE_EQ(1905.6, summaries[2].Duration);
+  EXPECT_EQ(15.25, summaries[2].Minimum);
+  EXPECT_EQ(181.75, summaries[2].Maximum);
+
+  ga::tc::StandardVector vector, filtered;
+  ga::tc::parse(vector, filepaths[0].c_str(), ga::tc::Parser::Mapped);
+  ga::tc::filter(filtered, vector, options.WindowSize, options.Threshold);
+  EXPECT_EQ(filtered.size(), summaries[0].Stable);
+
+  fs::path table = fs::temp_directory_path() / "gos-analysis-batch.csv";
+  ga::batch::write(summaries, table.string().c_str());
+  std::ifstream stream(table);
+  std::string line;
+  size_t lines = 0;
+  while (std::getline(stream, line)) {
+    lines++;
+  }
+  stream.close();
+  EXPECT_EQ(4, lines);
+  fs::remove(table);
+}
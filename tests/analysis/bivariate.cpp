@@ -0,0 +1,68 @@
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/bivariate.h>
+#include <gos/analysis/tc.h>
+
+namespace ga = ::gos::analysis;
+
+TEST(AnalysisBivariateTest, Covariance) {
+  const double x[] = { 100.0, 1.0, 2.0, 3.0, 4.0, 5.0 };
+  const double y[] = { -50.0, 2.0, 4.0, 6.0, 8.0, 10.0 };
+  ga::bivariate bivariate(5);
+  for (size_t i = 0; i < 6; i++) {
+    bivariate.add(x[i], y[i]);
+  }
+  EXPECT_EQ(5, bivariate.count());
+  EXPECT_NEAR(3.0, bivariate.meanx(), 1e-9);
+  EXPECT_NEAR(6.0, bivariate.meany(), 1e-9);
+  EXPECT_NEAR(2.0, bivariate.variancex(), 1e-9);
+  EXPECT_NEAR(8.0, bivariate.variancey(), 1e-9);
+  EXPECT_NEAR(4.0, bivariate.covariance(), 1e-9);
+  EXPECT_NEAR(1.0, bivariate.correlation(), 1e-9);
+}
+
+TEST(AnalysisBivariateTest, Rolling) {
+  ga::bivariate bivariate(30);
+  std::vector<double> xs, ys;
+  for (size_t i = 0; i < 1000; i++) {
+    double x = ::sin(0.1 * i) + 0.01 * (i % 5);
+    double y = ::cos(0.07 * i) + 0.02 * (i % 3);
+    xs.push_back(x);
+    ys.push_back(y);
+    bivariate.add(x, y);
+    if (i % 17 == 0 && i >= 30) {
+      double mx = 0.0, my = 0.0, c = 0.0;
+      for (size_t j = i - 29; j <= i; j++) {
+        mx += xs[j];
+        my += ys[j];
+      }
+      mx /= 30.0;
+      my /= 30.0;
+      for (size_t j = i - 29; j <= i; j++) {
+        c += (xs[j] - mx) * (ys[j] - my);
+      }
+      EXPECT_NEAR(c / 30.0, bivariate.covariance(), 1e-12);
+    }
+  }
+}
+
+TEST(AnalysisBivariateTest, Correlate) {
+  ga::tc::StandardVector source;
+  for (size_t i = 0; i < 100; i++) {
+    double control = static_cast<double>((i * 37) % 11);
+    source.push_back(ga::tc::Standard(
+      static_cast<double>(i), control, 20.0));
+  }
+  /* The temperature follows the control three samples later */
+  for (size_t i = 3; i < source.size(); i++) {
+    source[i].Temperature = 20.0 + 2.0 * source[i - 3].Control;
+  }
+  ga::tc::CorrelationVector correlation;
+  ga::tc::correlate(correlation, source, 20, 3);
+  EXPECT_EQ(97, correlation.size());
+  EXPECT_DOUBLE_EQ(3.0, correlation.front().Time);
+  EXPECT_NEAR(1.0, correlation.back().Coefficient, 1e-12);
+}
@@ -0,0 +1,65 @@
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/duration.h>
+#include <gos/analysis/window.h>
+#include <gos/analysis/tc.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+TEST(AnalysisDurationTest, Evict) {
+  ga::duration duration(3.0);
+  duration.add(900.0, 0.0);
+  duration.add(600.0, 1.0);
+  duration.add(470.0, 1.5);
+  duration.add(170.0, 2.8);
+  EXPECT_EQ(4, duration.count());
+  duration.add(430.0, 4.2);
+  EXPECT_EQ(3, duration.count());
+  EXPECT_DOUBLE_EQ(470.0, duration.at(0));
+  EXPECT_NEAR(1070.0, duration.sum(), 1e-9);
+
+  duration.set(1.0);
+  EXPECT_EQ(1, duration.count());
+  EXPECT_DOUBLE_EQ(430.0, duration.mean());
+  EXPECT_DOUBLE_EQ(0.0, duration.variance());
+}
+
+TEST(AnalysisDurationTest, Regular) {
+  ga::duration duration(50.0);
+  ga::window window(50);
+  for (size_t i = 0; i < 5000; i++) {
+    double value = 40.0 + 10.0 * ::sin(0.03 * i) + 0.25 * (i % 4);
+    duration.add(value, static_cast<double>(i));
+    window.add(value);
+    if (i % 101 == 0) {
+      EXPECT_EQ(window.count(), duration.count());
+      EXPECT_NEAR(window.mean(), duration.mean(), 1e-9);
+      EXPECT_NEAR(window.variance(), duration.variance(), 1e-9);
+    }
+  }
+}
+
+TEST(AnalysisDurationTest, Order) {
+  ga::duration duration(10.0);
+  duration.add(1.0, 5.0);
+  duration.add(2.0, 5.0);
+  EXPECT_THROW(duration.add(3.0, 4.0), ga::exception);
+  EXPECT_THROW(duration.add(3.0, std::nan("")), ga::exception);
+  EXPECT_EQ(2, duration.count());
+  EXPECT_DOUBLE_EQ(1.5, duration.mean());
+
+  ga::tc::StandardVector source, destination;
+  source.emplace_back(0.0, 0.0, 20.0);
+  source.emplace_back(2.0, 0.0, 20.0);
+  source.emplace_back(1.0, 0.0, 20.0);
+  EXPECT_THROW(ga::tc::filterspan(destination, source, 60.0, 0.25),
+    ga::exception);
+  source.pop_back();
+  destination.clear();
+  ga::tc::filterspan(destination, source, 60.0, 0.25);
+  EXPECT_EQ(2, destination.size());
+}
@@ -0,0 +1,67 @@
+#include <cmath>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/exponential.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+TEST(AnalysisExponentialTest, Mean) {
+  ga::exponential exponential(0.5);
+  exponential.add(10.0);
+  exponential.add(20.0);
+  exponential.add(20.0);
+  EXPECT_EQ(3, exponential.count());
+  EXPECT_DOUBLE_EQ(17.5, exponential.mean());
+  EXPECT_DOUBLE_EQ(18.75, exponential.variance());
+}
+
+TEST(AnalysisExponentialTest, Nan) {
+  ga::exponential exponential(0.5), timed(0.5);
+  EXPECT_TRUE(exponential.add(10.0));
+  EXPECT_FALSE(exponential.add(NAN));
+  EXPECT_TRUE(exponential.add(20.0));
+  EXPECT_TRUE(exponential.add(20.0));
+  EXPECT_EQ(3, exponential.count());
+  EXPECT_DOUBLE_EQ(17.5, exponential.mean());
+  EXPECT_DOUBLE_EQ(18.75, exponential.variance());
+
+  /* A skipped sample leaves the weight of the next to the time since the
+     last sample taken */
+  timed.sethalflife(4.0);
+  EXPECT_TRUE(timed.add(0.0, 0.0));
+  EXPECT_FALSE(timed.add(NAN, 2.0));
+  EXPECT_FALSE(timed.add(5.0, NAN));
+  EXPECT_TRUE(timed.add(1.0, 4.0));
+  EXPECT_EQ(2, timed.count());
+  EXPECT_NEAR(0.5, timed.mean(), 1e-12);
+  EXPECT_FALSE(std::isnan(timed.sd()));
+}
+
+TEST(AnalysisExponentialTest, HalfLife) {
+  ga::exponential exponential;
+  exponential.sethalflife(4.0);
+  EXPECT_DOUBLE_EQ(4.0, exponential.halflife());
+  exponential.add(0.0);
+  for (int i = 0; i < 4; i++) {
+    exponential.add(1.0);
+  }
+  EXPECT_NEAR(0.5, exponential.mean(), 1e-12);
+  EXPECT_THROW(exponential.setalpha(1.5), ga::exception);
+}
+
+TEST(AnalysisExponentialTest, Time) {
+  ga::exponential regular, irregular;
+  regular.sethalflife(4.0);
+  irregular.sethalflife(4.0);
+  regular.add(0.0, 0.0);
+  irregular.add(0.0, 0.0);
+  for (int i = 1; i <= 4; i++) {
+    regular.add(1.0, static_cast<double>(i));
+  }
+  irregular.add(1.0, 4.0);
+  EXPECT_NEAR(0.5, regular.mean(), 1e-12);
+  EXPECT_NEAR(0.5, irregular.mean(), 1e-12);
+}
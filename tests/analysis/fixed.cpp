@@ -0,0 +1,76 @@
+#include <cmath>
+#include <cstdint>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/fixed.h>
+#include <gos/analysis/window.h>
+
+namespace ga = ::gos::analysis;
+
+TEST(AnalysisFixedWindowTest, Double) {
+  const double a1[] = { 900.0, 600.0, 470.0, 170.0, 430.0, 300.0 };
+  ga::fixed::window<double, 5> window;
+  for (auto v : a1) {
+    window.add(v);
+  }
+  EXPECT_EQ(5, window.count());
+  EXPECT_DOUBLE_EQ(600.0, window.at(0));
+  EXPECT_DOUBLE_EQ(1970.0, window.sum());
+  EXPECT_DOUBLE_EQ(394.0, window.mean());
+  EXPECT_DOUBLE_EQ(21704.0, window.variance());
+  EXPECT_DOUBLE_EQ(147.32277488562318, window.sd());
+  EXPECT_DOUBLE_EQ(430.0, window.median());
+}
+
+TEST(AnalysisFixedWindowTest, Float) {
+  const float a1[] = { 9.0F, 1.0F, 3.0F, 2.0F, 4.0F, 5.0F, 8.0F, 6.0F };
+  ga::fixed::window<float, 8> window;
+  for (auto v : a1) {
+    window.add(v);
+  }
+  EXPECT_DOUBLE_EQ(4.5, window.median());
+  EXPECT_DOUBLE_EQ(38.0, window.sum());
+}
+
+TEST(AnalysisFixedWindowTest, Integer) {
+  ga::fixed::window<std::int16_t, 4> window;
+  ga::window reference(4);
+  for (std::int16_t i = 0; i < 1000; i++) {
+    std::int16_t value = static_cast<std::int16_t>((i * 37) % 101 - 50);
+    window.add(value);
+    reference.add(value);
+  }
+  EXPECT_EQ(static_cast<std::int64_t>(reference.sum()), window.sum());
+  EXPECT_DOUBLE_EQ(reference.mean(), window.mean());
+  EXPECT_NEAR(reference.variance(), window.variance(), 1e-9);
+  EXPECT_DOUBLE_EQ(reference.median(), window.median());
+}
+
+TEST(AnalysisFixedWindowTest, Empty) {
+  /* The same as the runtime window */
+  ga::fixed::window<std::int32_t, 3> window;
+  ga::window reference(3);
+  EXPECT_EQ(reference.mean(), window.mean());
+  EXPECT_EQ(reference.median(), window.median());
+  EXPECT_TRUE(std::isnan(reference.variance()));
+  EXPECT_TRUE(std::isnan(window.variance()));
+  EXPECT_TRUE(std::isnan(window.sd()));
+}
+
+TEST(AnalysisFixedWindowTest, Rolling) {
+  ga::fixed::window<double, 17> window;
+  ga::window reference(17);
+  for (size_t i = 0; i < 2000; i++) {
+    double value = i % 97 == 0 ?
+      std::nan("") : static_cast<double>((i * 7919) % 1013) / 4.0;
+    EXPECT_EQ(reference.add(value), window.add(value));
+    if (i % 7 == 0 && reference.count() > 0) {
+      EXPECT_EQ(reference.count(), window.count());
+      EXPECT_NEAR(reference.mean(), window.mean(), 1e-9);
+      EXPECT_NEAR(reference.variance(), window.variance(), 1e-6);
+      EXPECT_DOUBLE_EQ(reference.median(), window.median());
+    }
+  }
+}
@@ -0,0 +1,150 @@
+#include <cmath>
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/tests/analysis.h>
+
+#include <gos/analysis/fopdt.h>
+#include <gos/analysis/pool.h>
+#include <gos/analysis/tc.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+namespace fs = ::std::filesystem;
+
+static void CreateResponse(
+  ga::tc::StandardVector& vector,
+  const double& gain,
+  const double& tau,
+  const double& theta,
+  const double& noise);
+
+TEST(AnalysisFopdtTest, Detect) {
+  ga::tc::StandardVector vector;
+  ga::fopdt::StepVector steps;
+  ga::fopdt::Options options;
+  /* A ramp to 80 at 100 s, a small change at 400 s and a step down at
+     600 s that is too short to fit */
+  for (size_t i = 0; i < 700; i++) {
+    double time = static_cast<double>(i);
+    double control = 0.0;
+    if (i >= 100) {
+      control = i < 104 ? 20.0 * static_cast<double>(i - 99) : 80.0;
+    }
+    if (i >= 400) {
+      control = 82.0;
+    }
+    if (i >= 650) {
+      control = 0.0;
+    }
+    vector.emplace_back(time, control, 20.0);
+  }
+  ga::fopdt::detect(steps, vector, options);
+  ASSERT_EQ(1, steps.size());
+  EXPECT_EQ(100, steps[0].Begin);
+  EXPECT_EQ(650, steps[0].End);
+  EXPECT_DOUBLE_EQ(100.0, steps[0].Time);
+  EXPECT_DOUBLE_EQ(0.0, steps[0].Before);
+  EXPECT_DOUBLE_EQ(80.0, steps[0].After);
+}
+
+TEST(AnalysisFopdtTest, Fit) {
+  ga::tc::StandardVector vector;
+  ga::fopdt::IdentificationVector identifications;
+  ga::fopdt::Options options;
+
+  CreateResponse(vector, 1.8, 240.0, 35.0, 0.25);
+  ga::fopdt::identify(identifications, vector, options);
+  ASSERT_EQ(1, identifications.size());
+  const ga::fopdt::Model& model = identifications[0].Fit;
+  EXPECT_EQ("", identifications[0].Error);
+  EXPECT_NEAR(1.8, model.Gain, 0.01);
+  EXPECT_NEAR(240.0, model.TimeConstant, 3.0);
+  EXPECT_NEAR(35.0, model.DeadTime, 1.0);
+  EXPECT_NEAR(20.0, model.Offset, 0.2);
+  EXPECT_NEAR(0.25, model.Error, 0.02);
+  EXPECT_LT(0.0, identifications[0].CohenCoon.Kp);
+  EXPECT_LT(0.0, identifications[0].ZieglerNichols.Ki);
+  EXPECT_LT(0.0, identifications[0].Imc.Kd);
+}
+
+TEST(AnalysisFopdtTest, Tune) {
+  ga::fopdt::Model model;
+  model.Gain = 2.0;
+  model.TimeConstant = 100.0;
+  model.DeadTime = 10.0;
+
+  ga::fopdt::Settings zn = ga::fopdt::tune(
+    model, ga::fopdt::Rule::ZieglerNichols, 0.0);
+  EXPECT_DOUBLE_EQ(6.0, zn.Kp);
+  EXPECT_DOUBLE_EQ(6.0 / 20.0, zn.Ki);
+  EXPECT_DOUBLE_EQ(30.0, zn.Kd);
+
+  ga::fopdt::Settings cc = ga::fopdt::tune(
+    model, ga::fopdt::Rule::CohenCoon, 0.0);
+  EXPECT_DOUBLE_EQ(5.0 * (4.0 / 3.0 + 0.025), cc.Kp);
+  EXPECT_DOUBLE_EQ(cc.Kp / (10.0 * 32.6 / 13.8), cc.Ki);
+  EXPECT_DOUBLE_EQ(cc.Kp * 40.0 / 11.2, cc.Kd);
+
+  /* Lambda is the larger of tau / 10 and 0.8 theta */
+  ga::fopdt::Settings imc = ga::fopdt::tune(
+    model, ga::fopdt::Rule::Imc, 0.0);
+  EXPECT_DOUBLE_EQ(210.0 / (2.0 * 30.0), imc.Kp);
+  EXPECT_DOUBLE_EQ(imc.Kp / 105.0, imc.Ki);
+  EXPECT_DOUBLE_EQ(imc.Kp * 1000.0 / 210.0, imc.Kd);
+
+  model.DeadTime = 0.0;
+  EXPECT_TRUE(std::isnan(ga::fopdt::tune(
+    model, ga::fopdt::Rule::ZieglerNichols, 0.0).Kp));
+  EXPECT_LT(0.0, ga::fopdt::tune(model, ga::fopdt::Rule::Imc, 0.0).Kp);
+}
+
+TEST(AnalysisFopdtTest, Runs) {
+  /* 191122.csv is next to the testing file var/tc/standard/200410a.csv */
+  fs::path standard = fs::path(GA_UNIT_TESTING_VAR_TC_STANDARD_PATH)
+    .parent_path();
+  std::vector<std::string> files = {
+    (standard / "191122.csv").string(),
+    (standard / "missing.csv").string() };
+  ga::fopdt::IdentificationVector identifications;
+  ga::pool pool(2);
+
+  ga::fopdt::identify(identifications, files, ga::fopdt::Options(), pool);
+  ASSERT_EQ(2, identifications.size());
+  EXPECT_EQ(files[0], identifications[0].File);
+  EXPECT_EQ("", identifications[0].Error);
+  EXPECT_DOUBLE_EQ(85.0, identifications[0].Change.After);
+  /* Heated from about 20 to 180 degrees by 85 */
+  const ga::fopdt::Model& model = identifications[0].Fit;
+  EXPECT_NEAR(1.85, model.Gain, 0.1);
+  EXPECT_LT(0.0, model.TimeConstant);
+  EXPECT_LE(0.0, model.DeadTime);
+  EXPECT_GT(5.0, model.Error);
+  EXPECT_EQ(files[1], identifications[1].File);
+  EXPECT_NE("", identifications[1].Error);
+}
+
+void CreateResponse(
+  ga::tc::StandardVector& vector,
+  const double& gain,
+  const double& tau,
+  const double& theta,
+  const double& noise) {
+  std::mt19937 generator(7);
+  std::normal_distribution<double> distribution(0.0, noise);
+  vector.clear();
+  for (size_t i = 0; i < 3000; i++) {
+    double time = 0.5 * static_cast<double>(i);
+    double control = time >= 60.0 ? 50.0 : 0.0;
+    double s = time - 60.0 - theta;
+    double temperature = 20.0 +
+      (s > 0.0 ? gain * 50.0 * (1.0 - std::exp(-s / tau)) : 0.0);
+    vector.emplace_back(time, control, temperature + distribution(generator));
+  }
+}
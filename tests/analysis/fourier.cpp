@@ -0,0 +1,164 @@
+#include <cmath>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/fourier.h>
+#include <gos/analysis/pool.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+/* M_PI is not standard and MSVC does not define it by default */
+static const double Pi = 3.14159265358979323846;
+
+static void GetDft(
+  ga::fourier::ComplexVector& destination,
+  const ga::fourier::ComplexVector& source);
+
+TEST(AnalysisFourierTest, Transform) {
+  std::mt19937 generator(11);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  for (size_t size : { 1, 2, 3, 4, 5, 6, 7, 8, 12, 15, 16, 30, 64, 97, 100,
+    210, 1024 }) {
+    ga::fourier::ComplexVector data(size), expected;
+    for (ga::fourier::Complex& value : data) {
+      value = ga::fourier::Complex(
+        distribution(generator), distribution(generator));
+    }
+    GetDft(expected, data);
+    const ga::fourier::plan& plan = ga::fourier::plan::cached(size);
+    EXPECT_EQ(size, plan.size());
+    ga::fourier::ComplexVector transformed(data);
+    plan.transform(transformed.data());
+    for (size_t k = 0; k < size; k++) {
+      EXPECT_NEAR(expected[k].real(), transformed[k].real(), 1e-9) << size;
+      EXPECT_NEAR(expected[k].imag(), transformed[k].imag(), 1e-9) << size;
+    }
+    plan.transform(transformed.data(), true);
+    for (size_t k = 0; k < size; k++) {
+      EXPECT_NEAR(data[k].real(), transformed[k].real() / size, 1e-12);
+      EXPECT_NEAR(data[k].imag(), transformed[k].imag() / size, 1e-12);
+    }
+  }
+  EXPECT_THROW(ga::fourier::plan(0), ga::exception);
+}
+
+TEST(AnalysisFourierTest, Real) {
+  /* R: fft(1:4) is 10, -2+2i, -2, -2-2i */
+  std::vector<double> values = { 1, 2, 3, 4 };
+  ga::fourier::ComplexVector coefficients(3);
+  ga::fourier::realplan::cached(4).forward(
+    coefficients.data(), values.data());
+  EXPECT_NEAR(10.0, coefficients[0].real(), 1e-12);
+  EXPECT_NEAR(-2.0, coefficients[1].real(), 1e-12);
+  EXPECT_NEAR(2.0, coefficients[1].imag(), 1e-12);
+  EXPECT_NEAR(-2.0, coefficients[2].real(), 1e-12);
+  EXPECT_NEAR(0.0, coefficients[2].imag(), 1e-12);
+
+  std::mt19937 generator(13);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  for (size_t size : { 1, 2, 9, 10, 48, 256, 500 }) {
+    values.resize(size);
+    ga::fourier::ComplexVector data(size), expected;
+    for (size_t i = 0; i < size; i++) {
+      values[i] = distribution(generator);
+      data[i] = values[i];
+    }
+    GetDft(expected, data);
+    coefficients.resize(size / 2 + 1);
+    ga::fourier::realplan::cached(size).forward(
+      coefficients.data(), values.data());
+    for (size_t k = 0; k < coefficients.size(); k++) {
+      EXPECT_NEAR(expected[k].real(), coefficients[k].real(), 1e-9) << size;
+      EXPECT_NEAR(expected[k].imag(), coefficients[k].imag(), 1e-9) << size;
+    }
+  }
+}
+
+TEST(AnalysisFourierTest, Welch) {
+  /* A 0.05 Hz oscillation of amplitude 2 sampled at 2 Hz with noise */
+  std::mt19937 generator(17);
+  std::normal_distribution<double> noise(0.0, 0.1);
+  std::vector<double> values(20000);
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = 150.0 + 2.0 * std::sin(2.0 * Pi * 0.05 * i / 2.0) +
+      noise(generator);
+  }
+  ga::fourier::Options options;
+  options.Segment = 400;
+  options.Overlap = 200;
+  options.Rate = 2.0;
+  ga::fourier::Spectrum spectrum;
+  ga::pool pool(3);
+
+  ga::fourier::welch(spectrum, values.data(), values.size(), options, pool);
+  EXPECT_EQ(99, spectrum.Segments);
+  ASSERT_EQ(201, spectrum.Power.size());
+  EXPECT_DOUBLE_EQ(1.0, spectrum.Frequency.back());
+  size_t peak = 0;
+  double total = 0.0;
+  for (size_t k = 0; k < spectrum.Power.size(); k++) {
+    if (spectrum.Power[k] > spectrum.Power[peak]) {
+      peak = k;
+    }
+    total += spectrum.Power[k];
+  }
+  EXPECT_DOUBLE_EQ(0.05, spectrum.Frequency[peak]);
+  /* The integral of the density is the variance, 2 for the sine and 0.01
+     for the noise */
+  EXPECT_NEAR(2.01, total * options.Rate / options.Segment, 0.05);
+
+  ga::fourier::Spectrum single;
+  ga::pool one(1);
+  ga::fourier::welch(single, values.data(), values.size(), options, one);
+  EXPECT_EQ(spectrum.Power, single.Power);
+
+  EXPECT_THROW(ga::fourier::welch(spectrum, values.data(), 399, options,
+    pool), ga::exception);
+  options.Overlap = 400;
+  EXPECT_THROW(ga::fourier::welch(spectrum, values.data(), values.size(),
+    options, pool), ga::exception);
+}
+
+TEST(AnalysisFourierTest, Spectrogram) {
+  /* 0.1 Hz in the first half and 0.25 Hz in the second at 1 Hz */
+  ga::type::AlignedDoubleVector column(4096);
+  for (size_t i = 0; i < column.size(); i++) {
+    double frequency = i < 2048 ? 0.1 : 0.25;
+    column[i] = std::cos(2.0 * Pi * frequency * i);
+  }
+  ga::fourier::Options options;
+  options.Segment = 128;
+  options.Overlap = 0;
+  ga::fourier::Spectrogram spectrogram;
+
+  ga::fourier::spectrogram(spectrogram, column, options);
+  const size_t bins = spectrogram.Frequency.size();
+  ASSERT_EQ(32, spectrogram.Time.size());
+  ASSERT_EQ(32 * bins, spectrogram.Power.size());
+  EXPECT_DOUBLE_EQ(64.0, spectrogram.Time[0]);
+  for (size_t s = 0; s < spectrogram.Time.size(); s++) {
+    const double* row = spectrogram.Power.data() + s * bins;
+    size_t peak = std::max_element(row, row + bins) - row;
+    EXPECT_NEAR(s < 16 ? 0.1 : 0.25, spectrogram.Frequency[peak], 0.008);
+  }
+}
+
+void GetDft(
+  ga::fourier::ComplexVector& destination,
+  const ga::fourier::ComplexVector& source) {
+  const size_t n = source.size();
+  destination.assign(n, ga::fourier::Complex());
+  for (size_t k = 0; k < n; k++) {
+    for (size_t j = 0; j < n; j++) {
+      double angle = -2.0 * Pi * static_cast<double>((j * k) % n) / n;
+      destination[k] += source[j] *
+        ga::fourier::Complex(std::cos(angle), std::sin(angle));
+    }
+  }
+}
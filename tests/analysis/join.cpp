@@ -0,0 +1,106 @@
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/join.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+static std::int64_t GetNearestMatch(
+  const double& time,
+  const std::vector<double>& right,
+  const ga::join::Direction& direction,
+  const double& tolerance);
+
+TEST(AnalysisJoinTest, Asof) {
+  std::vector<double> left = {
+    10, 12, 15, 22, 30, 38, 39, 42, 44, 51, 52, 53, 60, 61 };
+  std::vector<double> right = {
+    2, 8, 9, 10, 15, 28, 30, 49, 55, 56, 57, 60, 61, 62 };
+  std::vector<char> names = {
+    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N' };
+  ga::join::IndexVector matches;
+  std::vector<char> aligned;
+
+  ga::join::asof(matches, left.data(), left.size(), right.data(),
+    right.size(), ga::join::Direction::Nearest);
+  ga::join::gather(aligned, names, matches, '-');
+  EXPECT_THAT(aligned, ::testing::ElementsAre(
+    'D', 'D', 'E', 'F', 'G', 'G', 'G', 'H', 'H', 'H', 'H', 'I', 'L', 'M'));
+
+  ga::join::asof(matches, left.data(), left.size(), right.data(),
+    right.size(), ga::join::Direction::Backward, 3);
+  ga::join::gather(aligned, names, matches, '-');
+  EXPECT_THAT(aligned, ::testing::ElementsAre(
+    'D', 'D', 'E', '-', 'G', '-', '-', '-', '-', 'H', 'H', '-', 'L', 'M'));
+
+  ga::join::asof(matches, left.data(), left.size(), right.data(),
+    right.size(), ga::join::Direction::Forward);
+  ga::join::gather(aligned, names, matches, '-');
+  EXPECT_THAT(aligned, ::testing::ElementsAre(
+    'D', 'E', 'E', 'F', 'G', 'H', 'H', 'H', 'H', 'I', 'I', 'I', 'L', 'M'));
+
+  std::vector<double> unsorted = { 1, 3, 2 };
+  EXPECT_THROW(ga::join::asof(matches, unsorted.data(), unsorted.size(),
+    right.data(), right.size()), ga::exception);
+}
+
+TEST(AnalysisJoinTest, Parallel) {
+  std::mt19937 generator(7);
+  std::uniform_real_distribution<double> step(0.0, 1.0);
+  std::vector<double> left(300000), right(100000);
+  double time = 0.0;
+  for (double& value : left) {
+    value = (time += step(generator) * 0.25);
+  }
+  time = 0.0;
+  for (double& value : right) {
+    /* Whole steps so some right times repeat */
+    value = (time += std::floor(step(generator) * 2.0) * 0.5);
+  }
+  ga::pool pool(3);
+  const ga::join::Direction directions[] = {
+    ga::join::Direction::Backward,
+    ga::join::Direction::Forward,
+    ga::join::Direction::Nearest };
+  for (const ga::join::Direction& direction : directions) {
+    ga::join::IndexVector serial, parallel;
+    ga::join::asof(serial, left.data(), left.size(), right.data(),
+      right.size(), direction, 0.2);
+    ga::join::asof(parallel, left.data(), left.size(), right.data(),
+      right.size(), direction, 0.2, pool);
+    ASSERT_EQ(serial, parallel);
+    for (size_t i = 0; i < left.size(); i += 997) {
+      EXPECT_EQ(GetNearestMatch(left[i], right, direction, 0.2), serial[i]);
+    }
+  }
+}
+
+std::int64_t GetNearestMatch(
+  const double& time,
+  const std::vector<double>& right,
+  const ga::join::Direction& direction,
+  const double& tolerance) {
+  std::int64_t match = ga::join::None;
+  double best = tolerance;
+  for (size_t j = 0; j < right.size(); j++) {
+    double distance = std::abs(time - right[j]);
+    bool allowed =
+      (direction != ga::join::Direction::Backward || right[j] <= time) &&
+      (direction != ga::join::Direction::Forward || right[j] >= time);
+    /* The last of equal earlier times and the first of equal later times */
+    if (allowed && (distance < best || (distance == best &&
+      (match == ga::join::None || right[j] <= time)))) {
+      match = static_cast<std::int64_t>(j);
+      best = distance;
+    }
+  }
+  return match;
+}
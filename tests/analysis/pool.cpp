@@ -0,0 +1,71 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/pool.h>
+
+namespace ga = ::gos::analysis;
+
+TEST(AnalysisPoolTest, Submit) {
+  ga::pool pool(2);
+  std::future<int> future = pool.submit([]() { return 6 * 7; });
+  EXPECT_EQ(42, future.get());
+}
+
+TEST(AnalysisPoolTest, Run) {
+  ga::pool pool(4);
+  std::vector<size_t> values(1000, 0);
+  pool.run(values.size(), [&](size_t i) { values[i] = i * i; });
+  for (size_t i = 0; i < values.size(); i++) {
+    EXPECT_EQ(i * i, values[i]);
+  }
+}
+
+TEST(AnalysisPoolTest, RunThreads) {
+  /* The caller and one worker, never more threads than the pool size */
+  ga::pool pool(2);
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  pool.run(50, [&](size_t) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::unique_lock<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+  });
+  EXPECT_GE(2, threads.size());
+}
+
+TEST(AnalysisPoolTest, Nested) {
+  ga::pool pool(2);
+  std::atomic<size_t> sum(0);
+  pool.run(8, [&](size_t i) {
+    pool.run(8, [&](size_t j) { sum += i * 8 + j; });
+  });
+  EXPECT_EQ(63 * 64 / 2, sum.load());
+}
+
+TEST(AnalysisPoolTest, Exception) {
+  ga::pool pool(2);
+  EXPECT_THROW(pool.run(10, [](size_t i) {
+    if (i == 5) {
+      throw std::runtime_error("five");
+    }
+  }), std::runtime_error);
+}
+
+TEST(AnalysisPoolTest, Steal) {
+  ga::pool pool(2);
+  /* The inner task is queued on the worker running the outer task, which
+     waits for it, so only the other worker stealing it can run it */
+  std::future<int> outer = pool.submit([&pool]() {
+    std::future<int> inner = pool.submit([]() { return 42; });
+    return inner.get();
+  });
+  EXPECT_EQ(42, outer.get());
+}
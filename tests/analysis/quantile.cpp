@@ -0,0 +1,87 @@
+#include <cmath>
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/quantile.h>
+
+namespace ga = ::gos::analysis;
+
+static double Quantile(ga::type::DoubleVector sorted, const double& p);
+
+TEST(AnalysisQuantileTest, Value) {
+  const double a1[] = { 9.0, 1.0, 3.0, 6.0, 3.0, 8.0, 7.0, 2.0 };
+  ga::quantile quantile(7);
+  for (auto v : a1) {
+    quantile.add(v);
+  }
+  EXPECT_EQ(7, quantile.count());
+  EXPECT_DOUBLE_EQ(3.0, quantile.median());
+  EXPECT_DOUBLE_EQ(1.0, quantile.value(0.0));
+  EXPECT_DOUBLE_EQ(8.0, quantile.value(1.0));
+  EXPECT_DOUBLE_EQ(1.3, quantile.value(0.05));
+  EXPECT_DOUBLE_EQ(7.7, quantile.value(0.95));
+
+  ga::type::DoubleVector values;
+  quantile.values(values, { 0.25, 0.75 });
+  EXPECT_THAT(values, ::testing::ElementsAre(2.5, 6.5));
+}
+
+TEST(AnalysisQuantileTest, Mad) {
+  const double a1[] = { 1.0, 1.0, 2.0, 2.0, 4.0, 6.0, 9.0 };
+  ga::quantile quantile(7);
+  for (auto v : a1) {
+    quantile.add(v);
+  }
+  EXPECT_DOUBLE_EQ(1.0, quantile.mad());
+}
+
+TEST(AnalysisQuantileTest, Nan) {
+  ga::quantile quantile(3);
+  EXPECT_TRUE(quantile.add(1.0));
+  EXPECT_FALSE(quantile.add(NAN));
+  EXPECT_TRUE(quantile.add(3.0));
+  EXPECT_EQ(2, quantile.count());
+  EXPECT_DOUBLE_EQ(2.0, quantile.median());
+  EXPECT_DOUBLE_EQ(1.0, quantile.mad());
+  EXPECT_TRUE(quantile.add(5.0));
+  EXPECT_TRUE(quantile.add(7.0));
+  EXPECT_EQ(3, quantile.count());
+  EXPECT_DOUBLE_EQ(5.0, quantile.median());
+  EXPECT_DOUBLE_EQ(3.0, quantile.value(0.0));
+}
+
+TEST(AnalysisQuantileTest, Rolling) {
+  ga::quantile quantile(40);
+  ga::type::DoubleVector values;
+  for (size_t i = 0; i < 1000; i++) {
+    double value = static_cast<double>((i * 7919) % 211) / 4.0;
+    values.push_back(value);
+    quantile.add(value);
+    if (i % 11 == 0) {
+      size_t count = std::min(values.size(), static_cast<size_t>(40));
+      ga::type::DoubleVector last(values.end() - count, values.end());
+      double median = Quantile(last, 0.5);
+      ga::type::DoubleVector deviations;
+      for (auto v : last) {
+        deviations.push_back(::fabs(v - median));
+      }
+      EXPECT_DOUBLE_EQ(Quantile(last, 0.05), quantile.value(0.05));
+      EXPECT_DOUBLE_EQ(Quantile(last, 0.95), quantile.value(0.95));
+      EXPECT_DOUBLE_EQ(Quantile(deviations, 0.5), quantile.mad());
+    }
+  }
+}
+
+double Quantile(ga::type::DoubleVector sorted, const double& p) {
+  std::sort(sorted.begin(), sorted.end());
+  double position = p * (sorted.size() - 1);
+  size_t lower = static_cast<size_t>(::floor(position));
+  double fraction = position - lower;
+  if (lower + 1 < sorted.size()) {
+    return sorted[lower] + fraction * (sorted[lower + 1] - sorted[lower]);
+  }
+  return sorted[lower];
+}
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/tests/analysis.h>
+
+#include <gos/analysis/raw.h>
+#include <gos/analysis/tc.h>
+#include <gos/analysis/binary.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+namespace fs = ::std::filesystem;
+
+static fs::path GetTestingVarTcPath();
+static std::string GetContent(const fs::path& path);
+
+TEST(AnalysisRawTest, Convert) {
+  fs::path tc = GetTestingVarTcPath();
+  fs::path directory = fs::temp_directory_path() / "gos-analysis-raw";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  fs::path csvpath = directory / "191122.csv";
+  fs::path tcbpath = directory / "191122.tcb";
+
+  size_t count = ga::tc::raw::convert(
+    (tc / "raw" / "191122.csv").string().c_str(),
+    csvpath.string().c_str());
+  ga::tc::raw::convert(
+    (tc / "raw" / "191122.csv").string().c_str(),
+    tcbpath.string().c_str(),
+    ga::tc::raw::Output::Binary);
+
+  ga::tc::StandardVector standard, converted;
+  ga::tc::StandardFrame binary;
+  ga::tc::parse(standard, (tc / "standard" / "191122.csv").string().c_str(),
+    ga::tc::Parser::Mapped);
+  ga::tc::parse(converted, csvpath.string().c_str(), ga::tc::Parser::Mapped);
+  ASSERT_TRUE(ga::tc::binary::read(binary, tcbpath.string().c_str()));
+
+  /* The standard file is only the important section from the start */
+  EXPECT_EQ(14634, count);
+  ASSERT_EQ(count, converted.size());
+  ASSERT_EQ(count, binary.size());
+  for (size_t i = 0; i < standard.size(); i++) {
+    EXPECT_EQ(standard[i].Time, converted[i].Time);
+    EXPECT_EQ(standard[i].Control, converted[i].Control);
+    EXPECT_EQ(standard[i].Temperature, converted[i].Temperature);
+    EXPECT_EQ(standard[i].Time, binary.Time[i]);
+    EXPECT_EQ(standard[i].Temperature, binary.Temperature[i]);
+  }
+
+  fs::remove_all(directory);
+}
+
+TEST(AnalysisRawTest, ConvertFailure) {
+  fs::path directory = fs::temp_directory_path() / "gos-analysis-raw-fail";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+  fs::path rawpath = directory / "raw.csv";
+  {
+    std::ofstream stream(rawpath);
+    for (int i = 0; i < 200000; i++) {
+      stream << i << ",0,10," << (20 + i % 7) << "\n";
+    }
+    stream << "200000,0,10,bad\n";
+  }
+
+  /* A failed conversion leaves the previous file and nothing else */
+  for (const char* name : { "previous.csv", "previous.tcb" }) {
+    fs::path destination = directory / name;
+    {
+      std::ofstream stream(destination);
+      stream << "previous";
+    }
+    ga::tc::raw::Output output = destination.extension() == ".csv" ?
+      ga::tc::raw::Output::Text : ga::tc::raw::Output::Binary;
+    EXPECT_THROW(ga::tc::raw::convert(rawpath.string().c_str(),
+      destination.string().c_str(), output), ga::exception);
+    EXPECT_EQ("previous", GetContent(destination));
+  }
+  EXPECT_EQ(3, std::distance(
+    fs::directory_iterator(directory), fs::directory_iterator()));
+
+  fs::remove_all(directory);
+}
+
+TEST(AnalysisRawTest, ConvertDirectory) {
+  fs::path tc = GetTestingVarTcPath();
+  fs::path directory = fs::temp_directory_path() / "gos-analysis-raw-dir";
+  fs::remove_all(directory);
+
+  size_t count = ga::tc::raw::convertdirectory(
+    (tc / "raw").string().c_str(),
+    directory.string().c_str());
+
+  EXPECT_EQ(2, count);
+  for (const char* name : { "191122.csv", "191123.csv" }) {
+    ga::tc::StandardVector standard, converted;
+    ga::tc::parse(standard, (tc / "standard" / name).string().c_str(),
+      ga::tc::Parser::Mapped);
+    ga::tc::parse(converted, (directory / name).string().c_str(),
+      ga::tc::Parser::Mapped);
+    ASSERT_LE(standard.size(), converted.size()) << name;
+    for (size_t i = 0; i < standard.size(); i++) {
+      EXPECT_EQ(standard[i].Time, converted[i].Time);
+      EXPECT_EQ(standard[i].Temperature, converted[i].Temperature);
+    }
+  }
+
+  fs::remove_all(directory);
+}
+
+std::string GetContent(const fs::path& path) {
+  std::ifstream stream(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(stream),
+    std::istreambuf_iterator<char>());
+}
+
+fs::path GetTestingVarTcPath() {
+  /* The testing file is var/tc/standard/200410a.csv */
+  return fs::path(GA_UNIT_TESTING_VAR_TC_STANDARD_PATH)
+    .parent_path().parent_path();
+}
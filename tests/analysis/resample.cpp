@@ -0,0 +1,168 @@
+#include <cmath>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/tests/analysis.h>
+
+#include <gos/analysis/resample.h>
+#include <gos/analysis/tc.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+TEST(AnalysisResampleTest, Grid) {
+  std::vector<double> time = { 0.4, 1.1, 2.5, 3.0, 4.9 };
+  ga::resample::Grid grid;
+
+  grid = ga::resample::grid(time.data(), time.size(), 1.0,
+    ga::resample::Mode::Linear);
+  EXPECT_DOUBLE_EQ(1.0, grid.Start);
+  EXPECT_EQ(4, grid.Count);
+  EXPECT_DOUBLE_EQ(4.0, grid.at(3));
+
+  grid = ga::resample::grid(time.data(), time.size(), 1.0,
+    ga::resample::Mode::Mean);
+  EXPECT_DOUBLE_EQ(0.0, grid.Start);
+  EXPECT_EQ(5, grid.Count);
+
+  EXPECT_THROW(ga::resample::grid(time.data(), time.size(), 0.0,
+    ga::resample::Mode::Linear), ga::exception);
+  time[2] = 0.5;
+  EXPECT_THROW(ga::resample::grid(time.data(), time.size(), 1.0,
+    ga::resample::Mode::Linear), ga::exception);
+
+  /* Times that are not finite or a grid too large for a size_t */
+  std::vector<double> infinite = { 0.0, INFINITY };
+  std::vector<double> nan = { NAN };
+  std::vector<double> wide = { -1e300, 1e300 };
+  for (ga::resample::Mode mode :
+    { ga::resample::Mode::Linear, ga::resample::Mode::Mean }) {
+    EXPECT_THROW(ga::resample::grid(infinite.data(), infinite.size(), 1.0,
+      mode), ga::exception);
+    EXPECT_THROW(ga::resample::grid(nan.data(), nan.size(), 1.0, mode),
+      ga::exception);
+    EXPECT_THROW(ga::resample::grid(wide.data(), wide.size(), 1.0, mode),
+      ga::exception);
+  }
+  ga::tc::StandardFrame source, destination;
+  source.emplace_back(NAN, 0, 20);
+  EXPECT_THROW(ga::resample::resample(destination, source, 1.0),
+    ga::exception);
+}
+
+TEST(AnalysisResampleTest, Modes) {
+  std::vector<double> time = { 0.0, 0.5, 2.0, 2.5, 4.0 };
+  std::vector<double> first = { 0.0, 1.0, 4.0, 5.0, 8.0 };
+  std::vector<double> second = { 10.0, 20.0, 30.0, 40.0, 50.0 };
+  const double* columns[] = { first.data(), second.data() };
+  std::vector<double> a, b;
+  double* destinations[2];
+  ga::resample::Grid grid;
+
+  grid = ga::resample::grid(time.data(), time.size(), 1.0,
+    ga::resample::Mode::Linear);
+  ASSERT_EQ(5, grid.Count);
+  a.resize(grid.Count);
+  b.resize(grid.Count);
+  destinations[0] = a.data();
+  destinations[1] = b.data();
+  ga::resample::resample(destinations, columns, 2, time.data(), time.size(),
+    grid, ga::resample::Mode::Linear);
+  EXPECT_THAT(a, ::testing::ElementsAre(0.0, 2.0, 4.0, 6.0, 8.0));
+  EXPECT_DOUBLE_EQ(70.0 / 3.0, b[1]);
+  EXPECT_DOUBLE_EQ(130.0 / 3.0, b[3]);
+
+  ga::resample::resample(destinations, columns, 2, time.data(), time.size(),
+    grid, ga::resample::Mode::Previous);
+  EXPECT_THAT(a, ::testing::ElementsAre(0.0, 1.0, 4.0, 5.0, 8.0));
+  EXPECT_THAT(b, ::testing::ElementsAre(10.0, 20.0, 30.0, 40.0, 50.0));
+
+  grid = ga::resample::grid(time.data(), time.size(), 1.0,
+    ga::resample::Mode::Mean);
+  ga::resample::resample(destinations, columns, 2, time.data(), time.size(),
+    grid, ga::resample::Mode::Mean);
+  EXPECT_DOUBLE_EQ(0.5, a[0]);
+  EXPECT_TRUE(std::isnan(a[1]));
+  EXPECT_DOUBLE_EQ(4.5, a[2]);
+  EXPECT_TRUE(std::isnan(a[3]));
+  EXPECT_DOUBLE_EQ(8.0, a[4]);
+  EXPECT_DOUBLE_EQ(35.0, b[2]);
+}
+
+TEST(AnalysisResampleTest, Outside) {
+  std::vector<double> time = { 0.0, 0.5, 2.0, 2.5, 4.0 };
+  std::vector<double> value = { 0.0, 1.0, 4.0, 5.0, 8.0 };
+  const double* columns[] = { value.data() };
+  std::vector<double> a(8);
+  double* destinations[] = { a.data() };
+
+  /* A grid of the caller from before the first to after the last sample */
+  ga::resample::Grid grid = { -2.0, 1.0, 8 };
+  ga::resample::resample(destinations, columns, 1, time.data(), time.size(),
+    grid, ga::resample::Mode::Linear);
+  EXPECT_TRUE(std::isnan(a[0]));
+  EXPECT_TRUE(std::isnan(a[1]));
+  EXPECT_THAT(std::vector<double>(a.begin() + 2, a.begin() + 7),
+    ::testing::ElementsAre(0.0, 2.0, 4.0, 6.0, 8.0));
+  EXPECT_TRUE(std::isnan(a[7]));
+
+  ga::resample::resample(destinations, columns, 1, time.data(), time.size(),
+    grid, ga::resample::Mode::Previous);
+  EXPECT_TRUE(std::isnan(a[0]));
+  EXPECT_TRUE(std::isnan(a[1]));
+  EXPECT_THAT(std::vector<double>(a.begin() + 2, a.end()),
+    ::testing::ElementsAre(0.0, 1.0, 4.0, 5.0, 8.0, 8.0));
+
+  /* Bins [1, 2) and [2, 3), the samples around them are not averaged in */
+  grid = { 1.0, 1.0, 2 };
+  ga::resample::resample(destinations, columns, 1, time.data(), time.size(),
+    grid, ga::resample::Mode::Mean);
+  EXPECT_TRUE(std::isnan(a[0]));
+  EXPECT_DOUBLE_EQ(4.5, a[1]);
+
+  /* A grid from grid keeps every sample, whatever the rounding */
+  std::vector<double> tenths = { 0.3, 0.7, 1.1, 2.3 };
+  std::vector<double> ones(tenths.size(), 1.0);
+  const double* column[] = { ones.data() };
+  for (ga::resample::Mode mode : { ga::resample::Mode::Linear,
+    ga::resample::Mode::Previous, ga::resample::Mode::Mean }) {
+    grid = ga::resample::grid(tenths.data(), tenths.size(), 0.1, mode);
+    std::vector<double> b(grid.Count);
+    double* destination[] = { b.data() };
+    ga::resample::resample(destination, column, 1, tenths.data(),
+      tenths.size(), grid, mode);
+    size_t present = 0;
+    for (double v : b) {
+      present += std::isnan(v) ? 0 : 1;
+      EXPECT_TRUE(std::isnan(v) || v == 1.0);
+    }
+    EXPECT_EQ(mode == ga::resample::Mode::Mean ? 4 : grid.Count, present);
+  }
+}
+
+TEST(AnalysisResampleTest, Frame) {
+  ga::tc::StandardFrame source, destination;
+
+  ga::tc::parse(source, GA_UNIT_TESTING_VAR_TC_STANDARD_PATH,
+    ga::tc::Parser::Mapped);
+  ASSERT_LT(1, source.size());
+  ga::resample::resample(destination, source, 0.5);
+  ASSERT_LT(0, destination.size());
+  EXPECT_LE(source.Time.front(), destination.Time.front());
+  EXPECT_GE(source.Time.back(), destination.Time.back());
+
+  size_t j = 0;
+  for (size_t i = 0; i < destination.size(); i++) {
+    EXPECT_DOUBLE_EQ(destination.Time.front() + 0.5 * i, destination.Time[i]);
+    while (j + 2 < source.size() && source.Time[j + 1] <= destination.Time[i]) {
+      j++;
+    }
+    double low = std::fmin(source.Temperature[j], source.Temperature[j + 1]);
+    double high = std::fmax(source.Temperature[j], source.Temperature[j + 1]);
+    EXPECT_LE(low - 1e-9, destination.Temperature[i]);
+    EXPECT_GE(high + 1e-9, destination.Temperature[i]);
+  }
+}
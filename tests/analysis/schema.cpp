@@ -0,0 +1,143 @@
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/tests/analysis.h>
+
+#include <gos/analysis/schema.h>
+#include <gos/analysis/pid.h>
+
+namespace ga = ::gos::analysis;
+namespace gs = ::gos::analysis::schema;
+namespace fs = ::std::filesystem;
+
+struct Name : gs::field<std::int32_t> {
+  static const char* name() { return "name"; }
+};
+
+struct Value : gs::field<double, gs::Missing::Mask> {
+  static const char* name() { return "value"; }
+};
+
+struct Count : gs::field<std::uint8_t, gs::Missing::Default> {
+  static const char* name() { return "count"; }
+};
+
+typedef gs::table<Name, Value, Count> Table;
+
+static fs::path GetTestingVarPidPath();
+
+TEST(AnalysisSchemaTest, Parse) {
+  std::string text(
+    "extra,value,name\r\n"
+    "x,1.5,1\r\n"
+    "y,,2\r\n"
+    "\r\n"
+    "z,-3,3\r\n");
+  Table table;
+
+  table.parse(text.data(), text.data() + text.size());
+
+  ASSERT_EQ(3, table.size());
+  EXPECT_THAT(table.column<Name>(), ::testing::ElementsAre(1, 2, 3));
+  EXPECT_THAT(table.column<Value>(), ::testing::ElementsAre(1.5, 0.0, -3));
+  EXPECT_THAT(table.mask<Value>(), ::testing::ElementsAre(1, 0, 1));
+  EXPECT_THAT(table.column<Count>(), ::testing::ElementsAre(0, 0, 0));
+  EXPECT_TRUE(table.mask<Name>().empty());
+}
+
+TEST(AnalysisSchemaTest, Blanks) {
+  std::string text(
+    "name,value,count\n"
+    "1, ,2\n"
+    "2 ,\t3.5 , 4\n"
+    " 3,\t,\n");
+  std::string missing("name,value\n1,2\n  ,3\n");
+  Table table;
+
+  table.parse(text.data(), text.data() + text.size());
+
+  ASSERT_EQ(3, table.size());
+  EXPECT_THAT(table.column<Name>(), ::testing::ElementsAre(1, 2, 3));
+  EXPECT_THAT(table.column<Value>(), ::testing::ElementsAre(0.0, 3.5, 0.0));
+  EXPECT_THAT(table.mask<Value>(), ::testing::ElementsAre(0, 1, 0));
+  EXPECT_THAT(table.column<Count>(), ::testing::ElementsAre(2, 4, 0));
+  EXPECT_THROW(table.parse(missing.data(), missing.data() + missing.size()),
+    ga::exception);
+  EXPECT_EQ(3, table.size());
+}
+
+TEST(AnalysisSchemaTest, Reject) {
+  std::string missing("name,value\n1,2\n,3\n");
+  std::string invalid("name,value\n1,2\n2.5,3\n");
+  std::string column("value\n1\n");
+  Table table;
+
+  EXPECT_THROW(table.parse(missing.data(), missing.data() + missing.size()),
+    ga::exception);
+  EXPECT_THROW(table.parse(invalid.data(), invalid.data() + invalid.size()),
+    ga::exception);
+  EXPECT_THROW(table.parse(column.data(), column.data() + column.size()),
+    ga::exception);
+  EXPECT_EQ(0, table.size());
+  EXPECT_TRUE(table.column<Name>().empty());
+  EXPECT_TRUE(table.mask<Value>().empty());
+}
+
+TEST(AnalysisSchemaTest, PidRoundLog) {
+  ga::pid::RoundLog log;
+
+  std::string filepath =
+    (GetTestingVarPidPath() / "csv" / "200419a.csv").string();
+
+  /* The header names a status column the lines do not have */
+  log.parse(filepath.c_str(), ga::pid::RoundColumns());
+
+  ASSERT_EQ(80515, log.size());
+  EXPECT_EQ(1, log.column<ga::pid::Round>()[0]);
+  EXPECT_EQ(3, log.column<ga::pid::Kp>()[0]);
+  EXPECT_EQ(0.0055, log.column<ga::pid::Ki>()[0]);
+  EXPECT_EQ(0, log.column<ga::pid::Output>()[0]);
+  EXPECT_EQ(42, log.column<ga::pid::Temperature>()[0]);
+  EXPECT_EQ(43.5, log.column<ga::pid::Temperature>()[1]);
+  EXPECT_EQ(0, log.mask<ga::pid::Time>()[0]);
+}
+
+TEST(AnalysisSchemaTest, PidControllerLog) {
+  ga::pid::ControllerLog log;
+
+  log.parse((GetTestingVarPidPath() / "csv" / "200414a.csv").string().c_str());
+
+  ASSERT_EQ(7916, log.size());
+  EXPECT_EQ(0.297, log.column<ga::pid::Time>()[1]);
+  EXPECT_EQ(1, log.mask<ga::pid::Time>()[1]);
+  EXPECT_EQ(3, log.column<ga::pid::Status>()[0]);
+  EXPECT_EQ(0.01, log.column<ga::pid::Ki>()[0]);
+  EXPECT_EQ(88, log.column<ga::pid::Output>()[0]);
+  EXPECT_EQ(49, log.column<ga::pid::Temperature>()[0]);
+  EXPECT_EQ(43.875, log.column<ga::pid::Integral>()[1]);
+}
+
+TEST(AnalysisSchemaTest, PidAutomaticLog) {
+  ga::pid::AutomaticLog log;
+
+  log.parse((GetTestingVarPidPath() / "csv" / "200413a.csv").string().c_str());
+
+  ASSERT_EQ(2974, log.size());
+  EXPECT_EQ(0, log.column<ga::pid::Automatic>()[0]);
+  EXPECT_EQ(1, log.column<ga::pid::Automatic>()[48]);
+  EXPECT_EQ(0, log.column<ga::pid::Automatic>()[2107]);
+  EXPECT_EQ(28.25, log.column<ga::pid::Temperature>()[0]);
+  EXPECT_EQ(93, log.column<ga::pid::Setpoint>()[0]);
+  EXPECT_EQ(66.5, log.column<ga::pid::Error>()[0]);
+  EXPECT_EQ(-1, log.column<ga::pid::Derivative>()[0]);
+}
+
+fs::path GetTestingVarPidPath() {
+  /* The testing file is var/tc/standard/200410a.csv */
+  return fs::path(GA_UNIT_TESTING_VAR_TC_STANDARD_PATH)
+    .parent_path().parent_path().parent_path() / "pid";
+}
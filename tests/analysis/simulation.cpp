@@ -0,0 +1,171 @@
+#include <cmath>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/simulation.h>
+#include <gos/analysis/fopdt.h>
+#include <gos/analysis/pool.h>
+#include <gos/analysis/exception.h>
+
+namespace ga = ::gos::analysis;
+
+static ga::simulation::Score GetReferenceScore(
+  const ga::simulation::Plant& plant,
+  const ga::simulation::Gains& gains,
+  const ga::simulation::Options& options);
+
+TEST(AnalysisSimulationTest, Discretize) {
+  ga::fopdt::Model model;
+  model.Gain = 1.8;
+  model.TimeConstant = 240.0;
+  model.DeadTime = 35.4;
+  model.Offset = 20.0;
+
+  ga::simulation::Plant plant = ga::simulation::discretize(model, 0.0, 2.0);
+  ASSERT_EQ(1, plant.A.size());
+  ASSERT_EQ(1, plant.B.size());
+  EXPECT_DOUBLE_EQ(std::exp(-2.0 / 240.0), plant.A[0]);
+  EXPECT_DOUBLE_EQ(1.8 * (1.0 - std::exp(-2.0 / 240.0)), plant.B[0]);
+  EXPECT_EQ(18, plant.Delay);
+  EXPECT_DOUBLE_EQ(20.0, plant.Offset);
+
+  model.TimeConstant = 0.0;
+  EXPECT_THROW(ga::simulation::discretize(model, 0.0, 2.0), ga::exception);
+}
+
+TEST(AnalysisSimulationTest, DiscretizeBefore) {
+  /* A step from a control of 40, the plant held at 40 rests at the
+     temperature of the model at the step */
+  ga::fopdt::Identification identification;
+  identification.Change.Before = 40.0;
+  identification.Change.After = 120.0;
+  identification.Fit.Gain = 0.5;
+  identification.Fit.TimeConstant = 100.0;
+  identification.Fit.DeadTime = 10.0;
+  identification.Fit.Offset = 60.0;
+
+  ga::simulation::Plant plant =
+    ga::simulation::discretize(identification, 1.0);
+  EXPECT_DOUBLE_EQ(40.0, plant.Offset);
+  double y = 0.0;
+  for (size_t k = 0; k < 10000; k++) {
+    y = plant.A[0] * y + plant.B[0] * identification.Change.Before;
+  }
+  EXPECT_NEAR(identification.Fit.Offset, plant.Offset + y, 1e-9);
+}
+
+TEST(AnalysisSimulationTest, Grid) {
+  ga::simulation::GainsVector candidates;
+  ga::simulation::grid(candidates, { 1.0, 2.0 }, { 0.1, 0.2, 0.3 }, { 5.0 });
+  ASSERT_EQ(6, candidates.size());
+  EXPECT_DOUBLE_EQ(1.0, candidates[2].Kp);
+  EXPECT_DOUBLE_EQ(0.3, candidates[2].Ki);
+  EXPECT_DOUBLE_EQ(2.0, candidates[3].Kp);
+  EXPECT_DOUBLE_EQ(0.1, candidates[3].Ki);
+  EXPECT_DOUBLE_EQ(5.0, candidates[5].Kd);
+}
+
+TEST(AnalysisSimulationTest, Scores) {
+  /* A second order plant with a dead time */
+  ga::simulation::Plant plant;
+  plant.A = { 1.6, -0.64 };
+  plant.B = { 0.02, 0.01 };
+  plant.Delay = 3;
+  plant.Offset = 20.0;
+  ga::simulation::Options options;
+  options.Setpoint = 150.0;
+  options.Samples = 600;
+  ga::simulation::GainsVector candidates;
+  ga::simulation::grid(candidates, { 0.5, 2.0, 8.0 },
+    { 0.0, 0.01, 0.05 }, { 0.0, 1.0, 4.0 });
+  ga::simulation::ScoreVector scores;
+  ga::pool pool(2);
+
+  ga::simulation::simulate(scores, plant, candidates, options, pool);
+  ASSERT_EQ(candidates.size(), scores.size());
+  for (size_t i = 0; i < candidates.size(); i++) {
+    ga::simulation::Score reference = GetReferenceScore(
+      plant, candidates[i], options);
+    EXPECT_NEAR(reference.Iae, scores[i].Iae, 1e-9 * reference.Iae);
+    EXPECT_NEAR(reference.Ise, scores[i].Ise, 1e-9 * reference.Ise);
+    EXPECT_NEAR(reference.Overshoot, scores[i].Overshoot, 1e-12);
+    EXPECT_EQ(reference.Settling, scores[i].Settling);
+    ga::simulation::Score single = ga::simulation::simulate(
+      plant, candidates[i], options);
+    EXPECT_EQ(scores[i].Iae, single.Iae);
+  }
+}
+
+TEST(AnalysisSimulationTest, Tuned) {
+  ga::fopdt::Model model;
+  model.Gain = 1.8;
+  model.TimeConstant = 240.0;
+  model.DeadTime = 35.0;
+  model.Offset = 20.0;
+  ga::simulation::Plant plant = ga::simulation::discretize(model, 0.0, 1.0);
+  ga::simulation::Options options;
+
+  /* Without the integral the proportional control leaves an offset */
+  ga::simulation::Gains proportional;
+  proportional.Kp = 2.0;
+  ga::simulation::Score score = ga::simulation::simulate(
+    plant, proportional, options);
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), score.Settling);
+
+  ga::simulation::Gains imc = ga::fopdt::tune(
+    model, ga::fopdt::Rule::Imc, 0.0);
+  score = ga::simulation::simulate(plant, imc, options);
+  EXPECT_GT(0.1, score.Overshoot);
+  EXPECT_GT(static_cast<double>(options.Samples), score.Settling);
+  EXPECT_LT(model.DeadTime, score.Settling);
+}
+
+ga::simulation::Score GetReferenceScore(
+  const ga::simulation::Plant& plant,
+  const ga::simulation::Gains& gains,
+  const ga::simulation::Options& options) {
+  std::deque<double> ys(plant.A.size(), plant.Offset);
+  std::deque<double> us(plant.Delay + plant.B.size(), 0.0);
+  const double h = options.Step;
+  const double change = options.Setpoint - plant.Offset;
+  double integral = 0.0, previous = 0.0, peak = 0.0, last = 0.0;
+  ga::simulation::Score score;
+  for (size_t k = 0; k < options.Samples; k++) {
+    double y = plant.Offset;
+    for (size_t i = 0; i < plant.A.size(); i++) {
+      y += plant.A[i] * (ys[i] - plant.Offset);
+    }
+    for (size_t j = 0; j < plant.B.size(); j++) {
+      y += plant.B[j] * us[plant.Delay + j];
+    }
+    double e = options.Setpoint - y;
+    double next = integral + gains.Ki * h * e;
+    double free = gains.Kp * e + next -
+      (k == 0 ? 0.0 : gains.Kd * (y - previous) / h);
+    double u = std::min(std::max(free, options.Minimum), options.Maximum);
+    if (u == free) {
+      integral = next;
+    }
+    previous = y;
+    ys.push_front(y);
+    ys.pop_back();
+    us.push_front(u);
+    us.pop_back();
+    score.Iae += std::fabs(e) * h;
+    score.Ise += e * e * h;
+    peak = std::max(peak, (y - options.Setpoint) * (change < 0 ? -1 : 1));
+    if (std::fabs(e) > options.Band * std::fabs(change)) {
+      last = (k + 1) * h;
+    }
+  }
+  score.Overshoot = peak / std::fabs(change);
+  score.Settling = last >= options.Samples * h ?
+    std::numeric_limits<double>::infinity() : last;
+  return score;
+}
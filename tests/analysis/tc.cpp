@@ -1,5 +1,11 @@
+#include <cmath>
+#include <cstdint>
+
 #include <string>
 #include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -7,10 +13,14 @@
 #include <gos/analysis/tests/analysis.h>
 
 #include <gos/analysis/tc.h>
+#include <gos/analysis/exception.h>
+#include <gos/analysis/binary.h>
+#include <gos/analysis/exponential.h>
 
 namespace ga = ::gos::analysis;
 
 static std::string GetTestingVarFilePath();
+static double GetMedian(std::vector<double> values);
 
 TEST(AnalysisTcTest, Parse) {
   std::string varfilepath = GetTestingVarFilePath();
@@ -22,6 +32,313 @@ TEST(AnalysisTcTest, Parse) {
   EXPECT_EQ(3937, vector.size());
 }
 
+TEST(AnalysisTcTest, ParseMapped) {
+  std::string varfilepath = GetTestingVarFilePath();
+
+  ga::tc::StandardVector stream, mapped;
+
+  ga::tc::parse(stream, varfilepath.c_str(), ga::tc::Parser::Stream);
+  ga::tc::parse(mapped, varfilepath.c_str(), ga::tc::Parser::Mapped);
+
+  ASSERT_EQ(3937, mapped.size());
+  for (size_t i = 0; i < mapped.size(); i++) {
+    EXPECT_DOUBLE_EQ(stream[i].Time, mapped[i].Time);
+    EXPECT_DOUBLE_EQ(stream[i].Control, mapped[i].Control);
+    EXPECT_DOUBLE_EQ(stream[i].Temperature, mapped[i].Temperature);
+  }
+}
+
+TEST(AnalysisTcTest, ParseParallel) {
+  std::string varfilepath = GetTestingVarFilePath();
+
+  ga::tc::StandardVector mapped, parallel;
+
+  ga::tc::parse(mapped, varfilepath.c_str(), ga::tc::Parser::Mapped);
+  ga::tc::parse(parallel, varfilepath.c_str(), ga::tc::Parser::Parallel);
+
+  ASSERT_EQ(mapped.size(), parallel.size());
+  for (size_t i = 0; i < mapped.size(); i++) {
+    EXPECT_EQ(mapped[i].Time, parallel[i].Time);
+    EXPECT_EQ(mapped[i].Control, parallel[i].Control);
+    EXPECT_EQ(mapped[i].Temperature, parallel[i].Temperature);
+  }
+}
+
+TEST(AnalysisTcTest, Frame) {
+  std::string varfilepath = GetTestingVarFilePath();
+
+  ga::tc::StandardVector vector, filtered, converted;
+  ga::tc::StandardFrame frame, framefiltered;
+
+  ga::tc::parse(vector, varfilepath.c_str());
+  ga::tc::parse(frame, varfilepath.c_str());
+  ASSERT_EQ(vector.size(), frame.size());
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(frame.Temperature.data()) %
+    ga::aligned::Alignment);
+
+  ga::tc::filter(filtered, vector, 60, 0.25);
+  ga::tc::filter(framefiltered, frame, 60, 0.25);
+  ga::tc::convert(converted, framefiltered);
+  ASSERT_EQ(filtered.size(), converted.size());
+  for (size_t i = 0; i < filtered.size(); i++) {
+    EXPECT_EQ(filtered[i].Time, converted[i].Time);
+    EXPECT_EQ(filtered[i].Control, converted[i].Control);
+    EXPECT_EQ(filtered[i].Temperature, converted[i].Temperature);
+  }
+}
+
+TEST(AnalysisTcTest, Cache) {
+  std::filesystem::path directory =
+    std::filesystem::temp_directory_path() / "gos-analysis-tc-cache";
+  std::filesystem::create_directories(directory);
+  std::filesystem::path csvpath = directory / "200410a.csv";
+  std::filesystem::copy_file(GetTestingVarFilePath(), csvpath,
+    std::filesystem::copy_options::overwrite_existing);
+  std::string tcbpath = ga::tc::binary::path(csvpath.string().c_str());
+  std::filesystem::remove(tcbpath);
+
+  ga::tc::StandardFrame mapped, first, second, invalid;
+
+  ga::tc::parse(mapped, csvpath.string().c_str(), ga::tc::Parser::Mapped);
+  EXPECT_FALSE(ga::tc::binary::load(first, csvpath.string().c_str()));
+  ga::tc::parse(first, csvpath.string().c_str(), ga::tc::Parser::Cached);
+  ASSERT_TRUE(std::filesystem::exists(tcbpath));
+  EXPECT_TRUE(ga::tc::binary::load(second, csvpath.string().c_str()));
+  ASSERT_EQ(mapped.size(), first.size());
+  ASSERT_EQ(mapped.size(), second.size());
+  for (size_t i = 0; i < mapped.size(); i++) {
+    EXPECT_EQ(mapped.Time[i], second.Time[i]);
+    EXPECT_EQ(mapped.Control[i], second.Control[i]);
+    EXPECT_EQ(mapped.Temperature[i], second.Temperature[i]);
+  }
+
+  /* A damaged cache is rejected and replaced on the next parse */
+  {
+    std::fstream stream(tcbpath,
+      std::ios::binary | std::ios::in | std::ios::out);
+    stream.seekp(-1, std::ios::end);
+    stream.put('\x7f');
+  }
+  EXPECT_FALSE(ga::tc::binary::load(invalid, csvpath.string().c_str()));
+  ga::tc::StandardVector vector;
+  ga::tc::parse(vector, csvpath.string().c_str(), ga::tc::Parser::Cached);
+  EXPECT_EQ(mapped.size(), vector.size());
+  EXPECT_TRUE(ga::tc::binary::load(invalid, csvpath.string().c_str()));
+
+  /* A cache that cannot be opened is a miss, not an error */
+  std::filesystem::remove(tcbpath);
+  std::filesystem::create_directory(tcbpath);
+  ga::tc::StandardFrame unreadable;
+  EXPECT_FALSE(ga::tc::binary::load(unreadable, csvpath.string().c_str()));
+  EXPECT_FALSE(ga::tc::binary::read(unreadable, tcbpath.c_str()));
+  ga::tc::parse(unreadable, csvpath.string().c_str(), ga::tc::Parser::Cached);
+  EXPECT_EQ(mapped.size(), unreadable.size());
+
+  /* Sources differing only in extension have their own caches */
+  EXPECT_NE(ga::tc::binary::path("a.csv"), ga::tc::binary::path("a.txt"));
+  EXPECT_EQ("a.csv.tcb", ga::tc::binary::path("a.csv"));
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(AnalysisTcTest, CacheWriter) {
+  std::string tcbpath = (std::filesystem::temp_directory_path() /
+    "gos-analysis-writer.tcb").string();
+  std::string framepath = tcbpath + ".frame";
+
+  /* More than one block and not a multiple of four rows */
+  ga::tc::StandardFrame frame, written;
+  {
+    ga::tc::binary::writer writer(tcbpath.c_str(), 42);
+    for (size_t i = 0; i < 150003; i++) {
+      frame.emplace_back(0.1 * i, i % 255, 20.0 + 0.25 * (i % 13));
+      writer.add(frame.Time[i], frame.Control[i], frame.Temperature[i]);
+    }
+    EXPECT_FALSE(std::filesystem::exists(tcbpath));
+    writer.close();
+    EXPECT_EQ(150003, writer.count());
+    EXPECT_THROW(writer.close(), ga::exception);
+  }
+  ga::tc::binary::write(frame, framepath.c_str(), 42);
+  EXPECT_EQ(std::filesystem::file_size(framepath),
+    std::filesystem::file_size(tcbpath));
+  ASSERT_TRUE(ga::tc::binary::read(written, tcbpath.c_str()));
+  ASSERT_EQ(frame.size(), written.size());
+  EXPECT_EQ(frame.Time, written.Time);
+  EXPECT_EQ(frame.Control, written.Control);
+  EXPECT_EQ(frame.Temperature, written.Temperature);
+
+  /* A writer destroyed before close leaves nothing behind */
+  std::filesystem::remove(tcbpath);
+  {
+    ga::tc::binary::writer writer(tcbpath.c_str());
+    writer.add(0, 0, 20);
+  }
+  EXPECT_FALSE(std::filesystem::exists(tcbpath));
+  std::filesystem::remove(framepath);
+}
+
+TEST(AnalysisTcTest, Compact) {
+  std::string varfilepath = GetTestingVarFilePath();
+  std::string millisecondpath = (std::filesystem::path(varfilepath)
+    .parent_path() / "191122.csv").string();
+
+  ga::tc::StandardVector vector, restored, filtered, single;
+  ga::tc::CompactVector compact, compactfiltered;
+
+  /* The times of this run were stored in single precision and do not
+     fall on milliseconds */
+  ga::tc::parse(single, varfilepath.c_str());
+  EXPECT_THROW(ga::tc::convert(compact, single), ga::exception);
+
+  ga::tc::parse(vector, millisecondpath.c_str());
+  ga::tc::convert(compact, vector);
+  EXPECT_EQ(8, sizeof(ga::tc::Compact));
+  ASSERT_EQ(vector.size(), compact.size());
+  ga::tc::convert(restored, compact);
+  ASSERT_EQ(vector.size(), restored.size());
+  for (size_t i = 0; i < vector.size(); i++) {
+    EXPECT_EQ(vector[i].Time, restored[i].Time);
+    EXPECT_EQ(vector[i].Control, restored[i].Control);
+    EXPECT_EQ(vector[i].Temperature, restored[i].Temperature);
+  }
+
+  ga::tc::filter(filtered, vector, 60, 0.3);
+  ga::tc::filter(compactfiltered, compact, 60, 0.3);
+  ASSERT_EQ(filtered.size(), compactfiltered.size());
+  for (size_t i = 0; i < filtered.size(); i++) {
+    EXPECT_EQ(filtered[i].Time, compactfiltered[i].time());
+  }
+
+  EXPECT_TRUE(ga::tc::fits(ga::tc::Standard(1.008, 255, -20.75)));
+  EXPECT_FALSE(ga::tc::fits(ga::tc::Standard(1.0005, 0, 20)));
+  EXPECT_FALSE(ga::tc::fits(ga::tc::Standard(-1, 0, 20)));
+  EXPECT_FALSE(ga::tc::fits(ga::tc::Standard(0, 256, 20)));
+  EXPECT_FALSE(ga::tc::fits(ga::tc::Standard(0, 0.5, 20)));
+  EXPECT_FALSE(ga::tc::fits(ga::tc::Standard(0, 0, 20.1)));
+  EXPECT_FALSE(ga::tc::fits(ga::tc::Standard(0, 0, 9000)));
+  vector.push_back(ga::tc::Standard(4000, 0, 20.1));
+  EXPECT_THROW(ga::tc::convert(compact, vector), ga::exception);
+  EXPECT_EQ(restored.size(), compact.size());
+}
+
+TEST(AnalysisTcTest, CompactLargeWindow) {
+  /* Stretches of one and eight step swings near the lower limit, the
+     window is well past the size where the squares overflowed */
+  ga::tc::CompactVector compact, compactfiltered;
+  ga::tc::StandardVector vector, filtered;
+  for (std::uint32_t i = 0; i < 400000; i++) {
+    std::int16_t swing = (i / 50000) % 2 == 0 ? 1 : 8;
+    compact.push_back(ga::tc::Compact{
+      i, static_cast<std::int16_t>(-32000 + swing * (i % 2)), 0, 0});
+  }
+  ga::tc::convert(vector, compact);
+
+  ga::tc::filter(filtered, vector, 100000, 0.6);
+  ga::tc::filter(compactfiltered, compact, 100000, 0.6);
+  EXPECT_LT(0, compactfiltered.size());
+  EXPECT_GT(compact.size(), compactfiltered.size());
+  ASSERT_EQ(filtered.size(), compactfiltered.size());
+  for (size_t i = 0; i < filtered.size(); i++) {
+    EXPECT_EQ(filtered[i].Time, compactfiltered[i].time());
+  }
+}
+
+TEST(AnalysisTcTest, Reader) {
+  std::string varfilepath = GetTestingVarFilePath();
+
+  ga::tc::StandardVector vector, filtered, batchfiltered, batch;
+
+  ga::tc::parse(vector, varfilepath.c_str());
+  ga::tc::filter(filtered, vector, 60, 0.25);
+
+  ga::tc::reader reader(varfilepath.c_str(), 1000);
+  size_t batches = 0;
+  ga::window window(60);
+  while (reader.next(batch)) {
+    EXPECT_GE(1000, batch.size());
+    for (size_t i = 0; i < batch.size(); i++) {
+      EXPECT_EQ(vector[reader.count() - batch.size() + i].Time, batch[i].Time);
+    }
+    ga::tc::filter(batchfiltered, batch, window, 0.25);
+    batches++;
+  }
+  EXPECT_EQ(4, batches);
+  EXPECT_EQ(vector.size(), reader.count());
+  EXPECT_EQ(filtered.size(), batchfiltered.size());
+
+  ga::tc::reader all(varfilepath.c_str(), 7);
+  batchfiltered.clear();
+  ga::tc::filter(batchfiltered, all, 60, 0.25);
+  EXPECT_EQ(filtered.size(), batchfiltered.size());
+}
+
+TEST(AnalysisTcTest, FilterEmptyWindow) {
+  ga::tc::StandardVector vector, filtered;
+  ga::tc::StandardFrame frame, framefiltered;
+  ga::tc::CompactVector compact, compactfiltered;
+  for (int i = 0; i < 10; i++) {
+    vector.push_back(ga::tc::Standard(i, 0, 20));
+    frame.emplace_back(i, 0, 20);
+  }
+  ga::tc::convert(compact, vector);
+
+  ga::tc::filter(filtered, vector, 0, 0.3);
+  for (ga::tc::Criterion criterion : { ga::tc::Criterion::StandardDeviation,
+    ga::tc::Criterion::MedianAbsoluteDeviation,
+    ga::tc::Criterion::PeakToPeak }) {
+    ga::tc::filter(filtered, vector, 0, 0.3, criterion);
+  }
+  ga::tc::filter(framefiltered, frame, 0, 0.3);
+  ga::tc::filter(compactfiltered, compact, 0, 0.3);
+  EXPECT_TRUE(filtered.empty());
+  EXPECT_EQ(0, framefiltered.size());
+  EXPECT_TRUE(compactfiltered.empty());
+}
+
+TEST(AnalysisTcTest, FilterExponentialNan) {
+  /* A missing temperature does not stop the rows after it being kept */
+  ga::tc::StandardVector vector, filtered;
+  for (int i = 0; i < 20; i++) {
+    vector.push_back(ga::tc::Standard(i, 0, i == 5 ? NAN : 20.0));
+  }
+  ga::tc::filter(filtered, vector, ga::exponential(0.1), 0.25);
+  ASSERT_LE(19, filtered.size());
+  EXPECT_EQ(19.0, filtered.back().Time);
+}
+
+TEST(AnalysisTcTest, FilterMad) {
+  std::string varfilepath = GetTestingVarFilePath();
+
+  ga::tc::StandardVector vector, filtered;
+
+  ga::tc::parse(vector, varfilepath.c_str());
+  ga::tc::filter(filtered, vector, 60, 0.25,
+    ga::tc::Criterion::MedianAbsoluteDeviation);
+
+  /* The MAD of the last 60 temperatures from scratch at every row */
+  ga::tc::StandardVector expected;
+  for (size_t i = 0; i < vector.size(); i++) {
+    size_t first = i + 1 > 60 ? i + 1 - 60 : 0;
+    std::vector<double> last;
+    for (size_t j = first; j <= i; j++) {
+      last.push_back(vector[j].Temperature);
+    }
+    double median = GetMedian(last);
+    for (double& v : last) {
+      v = std::fabs(v - median);
+    }
+    if (GetMedian(last) < 0.25) {
+      expected.push_back(vector[i]);
+    }
+  }
+  ASSERT_EQ(expected.size(), filtered.size());
+  EXPECT_LT(0, filtered.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i].Time, filtered[i].Time);
+  }
+}
+
 std::string GetTestingVarFilePath() {
   std::string varfilepath(GA_UNIT_TESTING_VAR_TC_STANDARD_PATH);
 #ifdef _WIN32
@@ -29,3 +346,10 @@ std::string GetTestingVarFilePath() {
 #endif
   return varfilepath;
 }
+
+double GetMedian(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  size_t size = values.size();
+  return size % 2 == 0 ?
+    (values[size / 2 - 1] + values[size / 2]) / 2.0 : values[size / 2];
+}
@@ -0,0 +1,112 @@
+#include <filesystem>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/tests/analysis.h>
+
+#include <gos/analysis/tdms.h>
+#include <gos/analysis/tc.h>
+
+namespace ga = ::gos::analysis;
+namespace fs = ::std::filesystem;
+
+static fs::path GetTestingVarTcPath();
+
+TEST(AnalysisTdmsTest, Read) {
+  fs::path tc = GetTestingVarTcPath();
+
+  ga::tdms::file file((tc / "tdms" / "191122.tdms").string().c_str());
+  ga::tc::StandardFrame frame;
+  ga::tc::StandardVector standard;
+
+  ASSERT_EQ(3, file.channels().size());
+  EXPECT_EQ("Untitled", file.channels()[0].Group);
+  EXPECT_EQ("time", file.channels()[0].Name);
+  EXPECT_EQ(ga::tdms::Type::Double, file.channels()[0].DataType);
+  EXPECT_EQ(2, file.find("Untitled", "temperature"));
+  EXPECT_EQ(-1, file.find("Untitled", "output"));
+
+  ga::tdms::read(frame, file);
+  ga::tc::parse(standard, (tc / "standard" / "191122.csv").string().c_str(),
+    ga::tc::Parser::Mapped);
+  ASSERT_EQ(standard.size(), frame.size());
+  /* The temperature is one contiguous double channel, viewed in place */
+  const double* view = file.view(2);
+  ASSERT_NE(nullptr, view);
+  for (size_t i = 0; i < standard.size(); i++) {
+    EXPECT_EQ(standard[i].Time, frame.Time[i]);
+    EXPECT_EQ(standard[i].Control, frame.Control[i]);
+    EXPECT_EQ(standard[i].Temperature, frame.Temperature[i]);
+    EXPECT_EQ(standard[i].Temperature, view[i]);
+  }
+}
+
+TEST(AnalysisTdmsTest, Interleaved) {
+  fs::path tc = GetTestingVarTcPath();
+
+  /* Four single precision channels interleaved in every segment */
+  ga::tdms::file file((tc / "raw" / "200410a.tdms").string().c_str());
+  ga::tc::StandardVector standard;
+  ga::type::AlignedDoubleVector temperature;
+
+  int channel = file.find("pid", "temperature");
+  ASSERT_LE(0, channel);
+  EXPECT_EQ(ga::tdms::Type::Single, file.channels()[channel].DataType);
+  EXPECT_EQ(nullptr, file.view(channel));
+
+  file.read(temperature, channel);
+  ga::tc::parse(standard, GA_UNIT_TESTING_VAR_TC_STANDARD_PATH,
+    ga::tc::Parser::Mapped);
+  ASSERT_EQ(standard.size(), temperature.size());
+  for (size_t i = 0; i < standard.size(); i++) {
+    EXPECT_EQ(standard[i].Temperature, temperature[i]);
+  }
+}
+
+TEST(AnalysisTdmsTest, WithoutIndex) {
+  fs::path tc = GetTestingVarTcPath();
+  fs::path directory = fs::temp_directory_path() / "gos-analysis-tdms";
+  fs::remove_all(directory);
+  fs::create_directories(directory);
+
+  /* Only the .tdms is copied so the segments are scanned in the file */
+  for (fs::path source : {
+    tc / "tdms" / "191122.tdms", tc / "raw" / "200410a.tdms" }) {
+    fs::path copy = directory / source.filename();
+    fs::copy_file(source, copy);
+    ASSERT_FALSE(fs::exists(copy.string() + "_index"));
+    ASSERT_TRUE(fs::exists(source.string() + "_index"));
+
+    ga::tdms::file indexed(source.string().c_str());
+    ga::tdms::file scanned(copy.string().c_str());
+    ASSERT_EQ(indexed.channels().size(), scanned.channels().size());
+    ASSERT_LT(0, scanned.channels().size());
+    for (size_t i = 0; i < indexed.channels().size(); i++) {
+      const ga::tdms::Channel& expected = indexed.channels()[i];
+      const ga::tdms::Channel& channel = scanned.channels()[i];
+      EXPECT_EQ(expected.Group, channel.Group);
+      EXPECT_EQ(expected.Name, channel.Name);
+      EXPECT_EQ(expected.DataType, channel.DataType);
+      EXPECT_EQ(expected.Count, channel.Count);
+      EXPECT_EQ(expected.Chunks.size(), channel.Chunks.size());
+      ga::type::AlignedDoubleVector a, b;
+      indexed.read(a, i);
+      scanned.read(b, i);
+      EXPECT_EQ(expected.Count, b.size());
+      ASSERT_EQ(a.size(), b.size());
+      for (size_t j = 0; j < a.size(); j++) {
+        ASSERT_EQ(a[j], b[j]) << channel.Name << " " << j;
+      }
+    }
+  }
+
+  fs::remove_all(directory);
+}
+
+fs::path GetTestingVarTcPath() {
+  /* The testing file is var/tc/standard/200410a.csv */
+  return fs::path(GA_UNIT_TESTING_VAR_TC_STANDARD_PATH)
+    .parent_path().parent_path();
+}
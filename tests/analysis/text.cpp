@@ -0,0 +1,75 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <gos/analysis/text.h>
+
+namespace ga = ::gos::analysis;
+
+TEST(AnalysisTextTest, Number) {
+  const char* texts[] = {
+    "0", "31.25", "-0.0055", "+4.5", "87754496.000000", "1e-3", "2.5E4",
+    "123456789012345678", "0.1", "-17", ".5", "5." };
+  for (const char* text : texts) {
+    std::string s(text);
+    const char* cursor = s.data();
+    double value;
+    ASSERT_TRUE(ga::text::number(cursor, s.data() + s.size(), value)) << s;
+    EXPECT_EQ(::strtod(text, nullptr), value) << s;
+    EXPECT_EQ(s.data() + s.size(), cursor) << s;
+  }
+  for (int i = 0; i < 100000; i++) {
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%d.%03d", i * 7, i % 1000);
+    const char* cursor = buffer;
+    double value;
+    ASSERT_TRUE(ga::text::number(cursor, buffer + length, value));
+    EXPECT_EQ(::strtod(buffer, nullptr), value) << buffer;
+  }
+}
+
+TEST(AnalysisTextTest, Line) {
+  std::string s("time, control ,temperature\r\n0,0,31.25\n1,,31.5");
+  const char* first = s.data();
+  const char* last = s.data() + s.size();
+  EXPECT_EQ(2, ga::text::lines(first, last));
+  ga::text::StringVector fields;
+  ga::text::split(fields, first, ga::text::end(first, last));
+  EXPECT_THAT(fields, ::testing::ElementsAre("time", "control", "temperature"));
+  EXPECT_EQ(2, ga::text::find(fields, "temperature"));
+  EXPECT_EQ(-1, ga::text::find(fields, "output"));
+
+  const char* cursor = ga::text::next(ga::text::next(first, last), last);
+  double value;
+  EXPECT_TRUE(ga::text::number(cursor, last, value));
+  EXPECT_TRUE(ga::text::skip(cursor, last));
+  EXPECT_FALSE(ga::text::number(cursor, last, value));
+}
+
+TEST(AnalysisTextTest, Strict) {
+  const char* invalid[] = {
+    "12abc", "+-5", "++5", "-+5", "1.5.2", "3 4", "1e", "", " " };
+  for (const char* text : invalid) {
+    std::string s(text);
+    const char* cursor = s.data();
+    double value = 7.0;
+    EXPECT_FALSE(ga::text::number(cursor, s.data() + s.size(), value)) << s;
+    EXPECT_EQ(s.data(), cursor) << s;
+    EXPECT_EQ(7.0, value) << s;
+  }
+  std::string s(" 12.5 ,4;8");
+  const char* cursor = s.data();
+  const char* last = s.data() + s.size();
+  double value;
+  EXPECT_TRUE(ga::text::number(cursor, last, value));
+  EXPECT_EQ(12.5, value);
+  EXPECT_EQ(',', *cursor);
+  cursor++;
+  EXPECT_FALSE(ga::text::number(cursor, last, value));
+  EXPECT_TRUE(ga::text::number(cursor, last, value, ';'));
+  EXPECT_EQ(4.0, value);
+}
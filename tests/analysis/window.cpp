@@ -1,3 +1,7 @@
+#include <cmath>
+
+#include <algorithm>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -25,6 +29,161 @@ TEST(AnalysisWindowTest, Median) {
   EXPECT_DOUBLE_EQ(4.5, window.median());
 }
 
+TEST(AnalysisWindowTest, RollingMedian) {
+  ga::window window(51);
+  for (size_t i = 0; i < 2000; i++) {
+    window.add(static_cast<double>((i * 7919) % 1013) / 4.0);
+    if (i % 13 == 0) {
+      const ga::window& constant = window;
+      ga::type::DoubleVector sorted(window.vector());
+      std::sort(sorted.begin(), sorted.end());
+      size_t size = sorted.size();
+      double expected = size % 2 == 0 ?
+        (sorted[size / 2 - 1] + sorted[size / 2]) / 2.0 : sorted[size / 2];
+      EXPECT_DOUBLE_EQ(expected, constant.median());
+    }
+  }
+}
+
+TEST(AnalysisWindowTest, NanMedian) {
+  ga::window window(15);
+  window.median();
+  for (size_t i = 0; i < 300; i++) {
+    double value = i % 5 == 0 ?
+      std::nan("") : static_cast<double>((i * 7919) % 101);
+    EXPECT_EQ(!std::isnan(value), window.add(value));
+    ga::type::DoubleVector sorted(window.vector());
+    EXPECT_EQ(sorted.end(), std::find_if(sorted.begin(), sorted.end(),
+      [](const double& v) { return std::isnan(v); }));
+    std::sort(sorted.begin(), sorted.end());
+    size_t size = sorted.size();
+    if (size > 0) {
+      double expected = size % 2 == 0 ?
+        (sorted[size / 2 - 1] + sorted[size / 2]) / 2.0 : sorted[size / 2];
+      EXPECT_DOUBLE_EQ(expected, window.median());
+    }
+  }
+  const double batch[] = { 1.0, std::nan(""), 2.0 };
+  EXPECT_EQ(2, window.add(batch, 3));
+  EXPECT_DOUBLE_EQ(2.0, window.at(window.count() - 1));
+}
+
+TEST(AnalysisWindowTest, Extremes) {
+  ga::window window(25);
+  for (size_t i = 0; i < 1000; i++) {
+    window.add(i < 500 ?
+      static_cast<double>((i * 7919) % 331) - 100.0 :
+      static_cast<double>(i % 100));
+    if (i % 7 == 0) {
+      const ga::type::DoubleVector& vector = window.vector();
+      double minimum = *std::min_element(vector.begin(), vector.end());
+      double maximum = *std::max_element(vector.begin(), vector.end());
+      EXPECT_DOUBLE_EQ(minimum, window.minimum());
+      EXPECT_DOUBLE_EQ(maximum, window.maximum());
+      EXPECT_DOUBLE_EQ(maximum - minimum, window.peaktopeak());
+    }
+  }
+}
+
+TEST(AnalysisWindowTest, Range) {
+  const double a1[] = { 20.0, 19.0, -300.0, 21.0, 900.0, 22.0 };
+  ga::window reject(10), clamp(10), outlier(10);
+  reject.setrange(0.0, 100.0);
+  clamp.setrange(0.0, 100.0, ga::RangePolicy::Clamp);
+  outlier.setrange(0.0, 100.0, ga::RangePolicy::Outlier);
+  for (auto v : a1) {
+    reject.add(v);
+    clamp.add(v);
+    outlier.add(v);
+  }
+  EXPECT_EQ(4, reject.count());
+  EXPECT_DOUBLE_EQ(82.0, reject.sum());
+  EXPECT_EQ(6, clamp.count());
+  EXPECT_DOUBLE_EQ(182.0, clamp.sum());
+  EXPECT_EQ(6, outlier.count());
+  EXPECT_DOUBLE_EQ(682.0, outlier.sum());
+  EXPECT_EQ(2, reject.outliers());
+  EXPECT_EQ(2, clamp.outliers());
+  EXPECT_EQ(2, outlier.outliers());
+  EXPECT_FALSE(reject.add(101.0));
+}
+
+TEST(AnalysisWindowTest, Batch) {
+  ga::type::DoubleVector values;
+  for (size_t i = 0; i < 1000; i++) {
+    values.push_back(static_cast<double>((i * 7919) % 1013) / 4.0);
+  }
+  ga::window scalar(64), batch(64);
+  scalar.setrange(10.0, 200.0);
+  batch.setrange(10.0, 200.0);
+  size_t added = 0;
+  for (auto v : values) {
+    if (scalar.add(v)) {
+      added++;
+    }
+  }
+  size_t offset = 0, batchadded = 0;
+  for (size_t n : { 3, 17, 100, 5, 875 }) {
+    batchadded += batch.add(values.data() + offset, n);
+    offset += n;
+  }
+  EXPECT_EQ(added, batchadded);
+  EXPECT_EQ(scalar.outliers(), batch.outliers());
+  EXPECT_EQ(scalar.count(), batch.count());
+  EXPECT_EQ(scalar.vector(), batch.vector());
+  EXPECT_NEAR(scalar.mean(), batch.mean(), 1e-9);
+  EXPECT_NEAR(scalar.variance(), batch.variance(), 1e-9);
+  EXPECT_DOUBLE_EQ(scalar.median(), batch.median());
+  EXPECT_DOUBLE_EQ(scalar.maximum(), batch.maximum());
+
+  ga::window whole(64);
+  EXPECT_EQ(1000, whole.add(values.data(), values.size()));
+  EXPECT_DOUBLE_EQ(values.back(), whole.at(63));
+}
+
+TEST(AnalysisWindowTest, BatchNan) {
+  ga::type::DoubleVector values;
+  for (size_t i = 0; i < 600; i++) {
+    values.push_back(i % 23 == 0 ?
+      std::nan("") : static_cast<double>((i * 7919) % 1013) / 4.0);
+  }
+  for (ga::RangePolicy policy : { ga::RangePolicy::Reject,
+    ga::RangePolicy::Clamp, ga::RangePolicy::Outlier }) {
+    ga::window scalar(64), batch(64);
+    scalar.setrange(10.0, 200.0, policy);
+    batch.setrange(10.0, 200.0, policy);
+    size_t added = 0;
+    for (auto v : values) {
+      added += scalar.add(v) ? 1 : 0;
+    }
+    /* Batches with NaN as the only outlier and with other outliers */
+    size_t offset = 0, batchadded = 0;
+    for (size_t n : { 1, 2, 20, 3, 100, 474 }) {
+      batchadded += batch.add(values.data() + offset, n);
+      offset += n;
+    }
+    EXPECT_EQ(added, batchadded);
+    EXPECT_EQ(scalar.outliers(), batch.outliers());
+    EXPECT_EQ(scalar.vector(), batch.vector());
+    EXPECT_DOUBLE_EQ(scalar.median(), batch.median());
+  }
+}
+
+TEST(AnalysisWindowTest, Vector) {
+  const double a1[] = { 900.0, 600.0, 470.0, 170.0, 430.0, 300.0, 120.0 };
+  ga::window window;
+  CreateWindow(window, a1, 7, 5);
+  const ga::type::DoubleVector& vector = window.vector();
+  EXPECT_EQ(5, vector.size());
+  EXPECT_THAT(vector, ::testing::ElementsAre(470.0, 170.0, 430.0, 300.0, 120.0));
+  EXPECT_DOUBLE_EQ(470.0, window.at(0));
+  EXPECT_DOUBLE_EQ(120.0, window.at(4));
+
+  window.set(3);
+  EXPECT_THAT(window.vector(), ::testing::ElementsAre(430.0, 300.0, 120.0));
+  EXPECT_DOUBLE_EQ(850.0, window.sum());
+}
+
 TEST(AnalysisWindowTest, Sum) {
   const double a1[] = { 900.0, 600.0, 470.0, 170.0, 430.0, 300.0 };
   ga::window window;
@@ -57,6 +216,27 @@ TEST(AnalysisWindowTest, Sd) {
   EXPECT_DOUBLE_EQ(147.32277488562318, sd);
 }
 
+TEST(AnalysisWindowTest, RunningVariance) {
+  ga::window window(100);
+  for (size_t i = 0; i < 10000; i++) {
+    window.add(1000.0 + 25.0 * ::sin(0.01 * i) + 0.25 * (i % 7));
+    if (i % 997 == 0 || i == 9999) {
+      const ga::type::DoubleVector& vector = window.vector();
+      double mean = 0.0, variance = 0.0;
+      for (auto v : vector) {
+        mean += v;
+      }
+      mean /= vector.size();
+      for (auto v : vector) {
+        variance += (v - mean) * (v - mean);
+      }
+      variance /= vector.size();
+      EXPECT_NEAR(mean, window.mean(), 1e-9);
+      EXPECT_NEAR(variance, window.variance(), 1e-6);
+    }
+  }
+}
+
 void CreateWindow(
   ga::window& window,
   const double* array,
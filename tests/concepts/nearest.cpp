@@ -6,6 +6,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <gos/analysis/join.h>
+
 namespace gos {
 namespace analysis {
 namespace testing {
@@ -73,8 +75,8 @@ static bool operator<(const a& l, const a& r);
 static bool rcomparea(const a& l, const a& r);
 static bool operator<(const b& l, const b& r);
 
-static void combine(VectorC& vc, const VectorA& va, VectorB& vb);
-static void combine(VectorC& vc, const VectorB& vb, VectorA& va);
+static void combine(VectorC& vc, const VectorA& va, const VectorB& vb);
+static void combine(VectorC& vc, const VectorB& vb, const VectorA& va);
 
 TEST(AnalysisConceptsNearest, Oder) {
   std::sort(va.begin(), va.end(), rcomparea);
@@ -89,8 +91,18 @@ TEST(AnalysisConceptsNearest,  Combine) {
 
   VectorC vc;
   combine(vc, va, vb);
+  ASSERT_EQ(va.size(), vc.size());
+  EXPECT_EQ('D', vc[1].c);
+  EXPECT_EQ('G', vc[5].c);
+  EXPECT_EQ('H', vc[8].c);
+  EXPECT_EQ('M', vc[13].c);
   vc.clear();
   combine(vc, vb, va);
+  ASSERT_EQ(vb.size(), vc.size());
+  EXPECT_EQ(1, vc[0].n);
+  EXPECT_EQ(10, vc[7].n);
+  EXPECT_EQ(13, vc[10].n);
+  EXPECT_EQ(14, vc[13].n);
 }
 
 bool operator<(const a& l, const a& r) {
@@ -105,59 +117,49 @@ bool operator<(const b& l, const b& r) {
   return l.x < r.x;
 }
 
-void combine(VectorC& vc, const VectorA& va, VectorB& vb) {
-  IteratorB sit;
+/* The nearest b of every a from the as-of join of the library, the
+   earlier one on a tie */
+void combine(VectorC& vc, const VectorA& va, const VectorB& vb) {
+  std::vector<double> left, right;
   for (const a& a : va) {
+    left.push_back(a.x);
+  }
+  for (const b& b : vb) {
+    right.push_back(b.x);
+  }
+  join::IndexVector matches;
+  join::asof(matches, left.data(), left.size(), right.data(), right.size(),
+    join::Direction::Nearest);
+  for (size_t i = 0; i < va.size(); i++) {
     c c;
-    c.x = a.x;
-    c.n = a.n;
-    IteratorB it = vb.begin();
-    if (it != vb.end()) {
-      c.c = it->c;
-      while ((sit = it + 1) != vb.end()) {
-        if (a.x > it->x && a.x <= sit->x) {
-          if (std::abs(a.x - it->x) <= std::abs(a.x - sit->x)) {
-            c.c = it->c;
-          } else {
-            c.c = sit->c;
-          }
-          break;
-        }
-        it++;
-      }
-    }
+    c.x = va[i].x;
+    c.n = va[i].n;
+    c.c = matches[i] == join::None ?
+      '\0' : vb[static_cast<size_t>(matches[i])].c;
     vc.push_back(c);
   }
 }
 
-void combine(VectorC& vc, const VectorB& vb, VectorA& va) {
-  IteratorA sit;
+void combine(VectorC& vc, const VectorB& vb, const VectorA& va) {
+  std::vector<double> left, right;
   for (const b& b : vb) {
+    left.push_back(b.x);
+  }
+  for (const a& a : va) {
+    right.push_back(a.x);
+  }
+  join::IndexVector matches;
+  join::asof(matches, left.data(), left.size(), right.data(), right.size(),
+    join::Direction::Nearest);
+  for (size_t i = 0; i < vb.size(); i++) {
     c c;
-    c.x = b.x;
-    c.c = b.c;
-    IteratorA it = va.begin();
-    if (it != va.end()) {
-      c.n = it->n;
-      while ((sit = it + 1) != va.end()) {
-        if (b.x > it->x && b.x <= sit->x) {
-          if (std::abs(b.x - it->x) <= std::abs(b.x - sit->x)) {
-            c.n = it->n;
-          } else {
-            c.n = sit->n;
-          }
-          break;
-        }
-        it++;
-      }
-      if (b.x > it->x) {
-        c.n = it->n;
-      }
-    }
+    c.x = vb[i].x;
+    c.c = vb[i].c;
+    c.n = matches[i] == join::None ?
+      0 : va[static_cast<size_t>(matches[i])].n;
     vc.push_back(c);
   }
 }
-
 
 } // namespace concepts
 } // namespace testing